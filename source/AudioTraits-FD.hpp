@@ -11,13 +11,17 @@
 // NOTE: DO NOT INCLUDE THIS FILE DIRECTLY; INCLUDE THIS INSTEAD: AudioTraits.hpp
 
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 #include "ChannelSelection.hpp"
 #include "SignalAdapters.hpp"
 
 #include "FrequencySelection.hpp"
+#include "FrequencyDomain/CrossCorrelation.hpp"
 #include "FrequencyDomain/Helpers.hpp"
+#include "FrequencyDomain/STFT.hpp"
+#include "FrequencyDomain/SpectrumCache.hpp"
 
 namespace slb {
 namespace AudioTraits {
@@ -31,42 +35,71 @@ namespace AudioTraits {
  * To count as 'there is frequency content', it needs to be above a certain threshold in dB in at least one of the bins
  * in that band. The threshold is relative to the maximum bin value of all bins, across the entire spectrum.
  *
- * TODO: add option to re-use 'cache' the FFT results instead of recalculating every time.
+ * The FFT length (power of 2, 16..1048576) sets the trade-off between speed and frequency resolution.
+ *
+ * @note Wrap the signal in an AnalyzedSignal to re-use the FFT results across several checks.
  */
 struct HasSignalInAllBands
 {
+    using ChannelSeparable = std::true_type;
+    using FrequencyDomain = std::true_type;
+    
     static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, const Freqs& frequencySelection,
-                     float sampleRate, float threshold_dB = -0.5f)
+                     float sampleRate, float threshold_dB = -0.5f, int fftLength = FrequencyDomainHelpers::defaultFftLength)
     {
         if (frequencySelection.getRanges().empty()) {
             return false; // Empty frequency selection is always false
         }
         
-        // Each frequency band needs to be tested individually
-        for (const auto& frequencyRange : frequencySelection.getRanges()) {
-            // Determine bins where signal is expected
-            std::set<int> expectedBins = FrequencyDomainHelpers::determineCorrespondingBins(frequencyRange, sampleRate);
-            
-            for (int chNumber : selectedChannels) {
-                std::vector<float> channelSignal = signal.getChannelDataCopy(chNumber - 1); // channels are 1-based, indices 0-based
-                std::vector<float> normalizedBinValues = FrequencyDomainHelpers::getNormalizedBinValues(channelSignal);
-                
-                bool hasValidSignalInThisRange = false;
-                for (int expectedBin : expectedBins) {
-                    float binValue_dB = Utils::linear2Db(normalizedBinValues.at(expectedBin));
-                    if (binValue_dB >= threshold_dB) {
-                        hasValidSignalInThisRange = true;
-                        break; // at least one of the bins in this band has signal, skip the remaining bins in this band.
-                    }
-                }
-                if (hasValidSignalInThisRange == false) {
-                    return false; // channel did not have signal in any bin in this band
-                }
+        // Determine bins where signal is expected -- each frequency band needs to be tested individually
+        const std::vector<BinRange> expectedBinsPerBand = FrequencyDomainHelpers::determineBinsPerBand(frequencySelection, sampleRate, fftLength);
+        
+        const float threshold = Utils::dB2Linear(threshold_dB); // bins are compared in the linear domain
+        
+        std::vector<float> binValuesStorage;
+        for (int chNumber : selectedChannels) {
+            // channels are 1-based, indices 0-based
+            const std::vector<float>& normalizedBinValues = FrequencyDomainHelpers::getNormalizedBinValues(signal, chNumber - 1, binValuesStorage, fftLength);
+            if (!FrequencyDomainHelpers::anyInsideEachBand(normalizedBinValues, expectedBinsPerBand, threshold)) {
+                return false;
             }
         }
         
         return true;
     }
+    
+    /** Block-wise evaluation: process() consecutive blocks of the signal, then finish() */
+    class Accumulator
+    {
+    public:
+        Accumulator(const std::set<int>& selectedChannels, const Freqs& frequencySelection, float sampleRate,
+                    float threshold_dB = -0.5f, int fftLength = FrequencyDomainHelpers::defaultFftLength) :
+            m_expectedBinsPerBand(FrequencyDomainHelpers::determineBinsPerBand(frequencySelection, sampleRate, fftLength)),
+            m_threshold(Utils::dB2Linear(threshold_dB)),
+            m_spectra(selectedChannels, fftLength) {}
+        
+        void process(const ISignal& block) { m_spectra.process(block); }
+        
+        /** @returns true if the remaining blocks cannot change the result */
+        bool isDecided() const { return m_expectedBinsPerBand.empty(); }
+        bool finish()
+        {
+            if (m_expectedBinsPerBand.empty()) {
+                return false; // Empty frequency selection is always false
+            }
+            for (const auto& normalizedBinValues : m_spectra.getNormalizedBinValues()) {
+                if (!FrequencyDomainHelpers::anyInsideEachBand(normalizedBinValues, m_expectedBinsPerBand, m_threshold)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        
+    private:
+        std::vector<BinRange> m_expectedBinsPerBand;
+        float m_threshold; // linear
+        FrequencyDomainHelpers::ChannelSpectraAccumulator m_spectra;
+    };
 };
 
 /**
@@ -79,54 +112,329 @@ struct HasSignalInAllBands
  *
  * If any FFT bins (that are not part of the selected frequency bands) reach the threshold, the result will be 'false'.
  *
- * TODO: add option to re-use 'cache' the FFT results instead of recalculating every time.
+ * The FFT length (power of 2, 16..1048576) sets the trade-off between speed and frequency resolution.
+ *
+ * @note Wrap the signal in an AnalyzedSignal to re-use the FFT results across several checks.
  */
 struct HasSignalOnlyInBands
 {
+    using ChannelSeparable = std::true_type;
+    using FrequencyDomain = std::true_type;
+    
     static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, const Freqs& frequencySelection,
-                     float sampleRate, float threshold_dB = -0.5f)
+                     float sampleRate, float threshold_dB = -0.5f, int fftLength = FrequencyDomainHelpers::defaultFftLength)
     {
         // We only need to scan 'illegal' bands for content. If these are clean, the trait is true.
         // Determine bins where signal is allowed
-        std::set<int> legalBins = FrequencyDomainHelpers::determineCorrespondingBins(frequencySelection, sampleRate);
+        const BinMask legalBins = FrequencyDomainHelpers::determineCorrespondingBins(frequencySelection, sampleRate, fftLength);
+        
+        const float threshold = Utils::dB2Linear(threshold_dB); // bins are compared in the linear domain
         
+        std::vector<float> binValuesStorage;
         for (int chNumber : selectedChannels) {
-            std::vector<float> channelSignal = signal.getChannelDataCopy(chNumber - 1); // channels are 1-based, indices 0-based
-            std::vector<float> normalizedBinValues = FrequencyDomainHelpers::getNormalizedBinValues(channelSignal);
-        
-            for (int binIndex = 0; binIndex < FrequencyDomainHelpers::numBins; ++binIndex) {
-                float binValue_dB = Utils::linear2Db(normalizedBinValues.at(binIndex));
-                if (binValue_dB >= threshold_dB) {
-                    // there's content in this bin -- is this bin 'legal' ?
-                    // TODO: optimization -- change this to a vector<bool> or something (direct access rather than find)
-                    if (legalBins.find(binIndex) == legalBins.end()) {
-                        // this bin is not legal -> there's signal in at least one bin outside the legal bands
-                        return false;
-                    }
-                }
+            // channels are 1-based, indices 0-based
+            const std::vector<float>& normalizedBinValues = FrequencyDomainHelpers::getNormalizedBinValues(signal, chNumber - 1, binValuesStorage, fftLength);
+            if (!hasSignalOnlyInBins(normalizedBinValues, legalBins, threshold)) {
+                return false;
             }
         }
             
         return true;
     }
+    
+    /** Block-wise evaluation: process() consecutive blocks of the signal, then finish() */
+    class Accumulator
+    {
+    public:
+        Accumulator(const std::set<int>& selectedChannels, const Freqs& frequencySelection, float sampleRate,
+                    float threshold_dB = -0.5f, int fftLength = FrequencyDomainHelpers::defaultFftLength) :
+            m_legalBins(FrequencyDomainHelpers::determineCorrespondingBins(frequencySelection, sampleRate, fftLength)),
+            m_threshold(Utils::dB2Linear(threshold_dB)),
+            m_spectra(selectedChannels, fftLength) {}
+        
+        void process(const ISignal& block) { m_spectra.process(block); }
+        
+        /** @returns true if the remaining blocks cannot change the result */
+        bool isDecided() const { return false; } // bins are relative to the maximum of the entire spectrum
+        bool finish()
+        {
+            for (const auto& normalizedBinValues : m_spectra.getNormalizedBinValues()) {
+                if (!hasSignalOnlyInBins(normalizedBinValues, m_legalBins, m_threshold)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        
+    private:
+        BinMask m_legalBins;
+        float m_threshold; // linear
+        FrequencyDomainHelpers::ChannelSpectraAccumulator m_spectra;
+    };
+    
+private:
+    /** @returns true if no bin outside the legal bins reaches the (linear) threshold (i.e. there's no signal outside the legal bands) */
+    static bool hasSignalOnlyInBins(const std::vector<float>& normalizedBinValues, const BinMask& legalBins, float threshold)
+    {
+        return FrequencyDomainHelpers::maxOutsideMask(normalizedBinValues, legalBins) < threshold;
+    }
 };
 
 
 /** Can be used as a shorthand for HasSignalOnlyInBands, where the lower limit of the band is the minimum frequency (1Hz)*/
 struct HasSignalOnlyBelow
 {
-    static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, float frequency, float sampleRate, float threshold_dB = -0.5f)
+    using ChannelSeparable = std::true_type;
+    using FrequencyDomain = std::true_type;
+    
+    static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, float frequency, float sampleRate, float threshold_dB = -0.5f,
+                     int fftLength = FrequencyDomainHelpers::defaultFftLength)
     {
-        return HasSignalOnlyInBands::eval(signal, selectedChannels, Freqs{{1, frequency}}, sampleRate, threshold_dB);
+        return HasSignalOnlyInBands::eval(signal, selectedChannels, Freqs{{1, frequency}}, sampleRate, threshold_dB, fftLength);
     }
+    
+    /** Block-wise evaluation: process() consecutive blocks of the signal, then finish() */
+    class Accumulator : public HasSignalOnlyInBands::Accumulator
+    {
+    public:
+        Accumulator(const std::set<int>& selectedChannels, float frequency, float sampleRate, float threshold_dB = -0.5f,
+                    int fftLength = FrequencyDomainHelpers::defaultFftLength) :
+            HasSignalOnlyInBands::Accumulator(selectedChannels, Freqs{{1, frequency}}, sampleRate, threshold_dB, fftLength) {}
+    };
 };
 
 /** Can be used as a shorthand for HasSignalOnlyInBands, where the upper limit of the band is the maximum frequency (Nyquist=samplerate/2) */
 struct HasSignalOnlyAbove
 {
-    static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, float frequency, float sampleRate, float threshold_dB = -0.5f)
+    using ChannelSeparable = std::true_type;
+    using FrequencyDomain = std::true_type;
+    
+    static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, float frequency, float sampleRate, float threshold_dB = -0.5f,
+                     int fftLength = FrequencyDomainHelpers::defaultFftLength)
+    {
+        return HasSignalOnlyInBands::eval(signal, selectedChannels, Freqs{{frequency, sampleRate/2}}, sampleRate, threshold_dB, fftLength);
+    }
+    
+    /** Block-wise evaluation: process() consecutive blocks of the signal, then finish() */
+    class Accumulator : public HasSignalOnlyInBands::Accumulator
+    {
+    public:
+        Accumulator(const std::set<int>& selectedChannels, float frequency, float sampleRate, float threshold_dB = -0.5f,
+                    int fftLength = FrequencyDomainHelpers::defaultFftLength) :
+            HasSignalOnlyInBands::Accumulator(selectedChannels, Freqs{{frequency, sampleRate/2}}, sampleRate, threshold_dB, fftLength) {}
+    };
+};
+
+/**
+ * Evaluates if all the selected channels have frequency content in all the specified bands throughout a time range,
+ * e.g. to check that a filter sweep has reached a frequency after a given time.
+ *
+ * The signal is analyzed in short, overlapping frames (see ShortTimeFourierTransform): every frame whose center lies in
+ * the time range needs to have content above the threshold in at least one bin of every band. The threshold is relative
+ * to the maximum bin value of each frame. The analysis stops at the first frame without content.
+ *
+ * The FFT length (power of 2, 16..1048576) sets the trade-off between time and frequency resolution, the STFTSettings
+ * the hop size between frames and the window. If the time range contains no complete frame of the signal, the result is false.
+ */
+struct HasSignalInBandDuring
+{
+    using ChannelSeparable = std::true_type;
+    using FrequencyDomain = std::true_type;
+    
+    static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, const Freqs& frequencySelection,
+                     const TimeRange& timeRange, float sampleRate, float threshold_dB = -0.5f,
+                     int fftLength = FrequencyDomainHelpers::defaultStftLength, const STFTSettings& settings = STFTSettings{})
+    {
+        Accumulator accumulator(selectedChannels, frequencySelection, timeRange, sampleRate, threshold_dB, fftLength, settings);
+        accumulator.process(signal);
+        return accumulator.finish();
+    }
+    
+    /** Block-wise evaluation: process() consecutive blocks of the signal, then finish() */
+    class Accumulator
+    {
+    public:
+        Accumulator(const std::set<int>& selectedChannels, const Freqs& frequencySelection, const TimeRange& timeRange,
+                    float sampleRate, float threshold_dB = -0.5f, int fftLength = FrequencyDomainHelpers::defaultStftLength,
+                    const STFTSettings& settings = STFTSettings{}) :
+            m_expectedBinsPerBand(FrequencyDomainHelpers::determineBinsPerBand(frequencySelection, sampleRate, fftLength)),
+            m_threshold(Utils::dB2Linear(threshold_dB)),
+            m_analysis(selectedChannels, timeRange, sampleRate, fftLength, settings) {}
+        
+        void process(const ISignal& block)
+        {
+            if (isDecided()) {
+                return;
+            }
+            m_hasFrameWithoutSignal = !m_analysis.process(block, [this](const std::vector<float>& normalizedBinValues)
+            {
+                return FrequencyDomainHelpers::anyInsideEachBand(normalizedBinValues, m_expectedBinsPerBand, m_threshold);
+            });
+        }
+        
+        /** @returns true if the remaining blocks cannot change the result */
+        bool isDecided() const { return m_expectedBinsPerBand.empty() || m_hasFrameWithoutSignal || m_analysis.isComplete(); }
+        bool finish()
+        {
+            // Empty frequency selection is always false
+            return !m_expectedBinsPerBand.empty() && !m_hasFrameWithoutSignal && m_analysis.getNumFrames() > 0;
+        }
+        
+    private:
+        std::vector<BinRange> m_expectedBinsPerBand;
+        float m_threshold; // linear
+        FrequencyDomainHelpers::TimeRangeAnalysis m_analysis;
+        bool m_hasFrameWithoutSignal = false;
+    };
+};
+
+/**
+ * Evaluates if all the selected channels have frequency content in the specified bands only, throughout a time range.
+ * Like HasSignalOnlyInBands, but every frame whose center lies in the time range is evaluated individually (see
+ * HasSignalInBandDuring). The analysis stops at the first frame with content outside the bands.
+ *
+ * If the time range contains no complete frame of the signal, the result is true (there is no content outside the bands).
+ */
+struct HasSignalOnlyInBandsDuring
+{
+    using ChannelSeparable = std::true_type;
+    using FrequencyDomain = std::true_type;
+    
+    static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, const Freqs& frequencySelection,
+                     const TimeRange& timeRange, float sampleRate, float threshold_dB = -0.5f,
+                     int fftLength = FrequencyDomainHelpers::defaultStftLength, const STFTSettings& settings = STFTSettings{})
+    {
+        Accumulator accumulator(selectedChannels, frequencySelection, timeRange, sampleRate, threshold_dB, fftLength, settings);
+        accumulator.process(signal);
+        return accumulator.finish();
+    }
+    
+    /** Block-wise evaluation: process() consecutive blocks of the signal, then finish() */
+    class Accumulator
+    {
+    public:
+        Accumulator(const std::set<int>& selectedChannels, const Freqs& frequencySelection, const TimeRange& timeRange,
+                    float sampleRate, float threshold_dB = -0.5f, int fftLength = FrequencyDomainHelpers::defaultStftLength,
+                    const STFTSettings& settings = STFTSettings{}) :
+            m_legalBins(FrequencyDomainHelpers::determineCorrespondingBins(frequencySelection, sampleRate, fftLength)),
+            m_threshold(Utils::dB2Linear(threshold_dB)),
+            m_analysis(selectedChannels, timeRange, sampleRate, fftLength, settings) {}
+        
+        void process(const ISignal& block)
+        {
+            if (isDecided()) {
+                return;
+            }
+            m_hasFrameWithIllegalSignal = !m_analysis.process(block, [this](const std::vector<float>& normalizedBinValues)
+            {
+                return FrequencyDomainHelpers::maxOutsideMask(normalizedBinValues, m_legalBins) < m_threshold;
+            });
+        }
+        
+        /** @returns true if the remaining blocks cannot change the result */
+        bool isDecided() const { return m_hasFrameWithIllegalSignal || m_analysis.isComplete(); }
+        bool finish() { return !m_hasFrameWithIllegalSignal; }
+        
+    private:
+        BinMask m_legalBins;
+        float m_threshold; // linear
+        FrequencyDomainHelpers::TimeRangeAnalysis m_analysis;
+        bool m_hasFrameWithIllegalSignal = false;
+    };
+};
+
+/**
+ * Evaluates if the signal is delayed with respect to the reference signal by a given amount of samples (positive:
+ * the signal lags the reference, negative: it leads). The delay is estimated from the peak of the cross-correlation,
+ * so -- unlike IsDelayedVersionOf -- the signal does not need to match the reference sample by sample, and large
+ * time tolerances are cheap.
+ *
+ * The normalized cross-correlation at the peak needs to reach minCorrelation [0..1], otherwise the signal is not
+ * considered a delayed version of the reference (e.g. if it is silent or uncorrelated).
+ */
+struct HasDelayOf
+{
+    using ChannelSeparable = std::true_type;
+    using FrequencyDomain = std::true_type;
+    
+    static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, const ISignal& referenceSignal,
+                     int delay_samples, int timeTolerance_samples = 0, float minCorrelation = 0.5f)
+    {
+        SLB_ASSERT(timeTolerance_samples >= 0, "Invalid time tolerance");
+        SLB_ASSERT(minCorrelation > 0.f && minCorrelation <= 1.f, "Invalid correlation threshold");
+        
+        // Search a little beyond the tolerance, so a peak just outside of it is not mistaken for one at its edge
+        const int margin = timeTolerance_samples + 1;
+        const int minDelay = delay_samples - timeTolerance_samples - margin;
+        const int maxDelay = delay_samples + timeTolerance_samples + margin;
+        
+        for (int chNumber : selectedChannels) {
+            ChannelView channelSignal = signal.getChannelView(chNumber - 1); // channels are 1-based, indices 0-based
+            ChannelView channelSignalRef = referenceSignal.getChannelView(chNumber - 1); // channels are 1-based, indices 0-based
+            
+            DelayEstimate estimate = estimateDelay(channelSignal, channelSignalRef, minDelay, maxDelay);
+            if (!isWithinTolerance(estimate, delay_samples, timeTolerance_samples, minCorrelation)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    /**
+     * Block-wise evaluation: process() consecutive blocks of the signal, then finish().
+     * The reference signal is held by reference and must be fully available.
+     */
+    class Accumulator
+    {
+    public:
+        Accumulator(const std::set<int>& selectedChannels, const ISignal& referenceSignal, int delay_samples,
+                    int timeTolerance_samples = 0, float minCorrelation = 0.5f) :
+            m_delay(delay_samples),
+            m_timeTolerance(timeTolerance_samples),
+            m_minCorrelation(minCorrelation)
+        {
+            SLB_ASSERT(timeTolerance_samples >= 0, "Invalid time tolerance");
+            SLB_ASSERT(minCorrelation > 0.f && minCorrelation <= 1.f, "Invalid correlation threshold");
+            
+            const int margin = timeTolerance_samples + 1; // see eval()
+            m_estimators.reserve(selectedChannels.size());
+            for (int chNumber : selectedChannels) {
+                m_estimators.emplace_back(chNumber, FrequencyDomainHelpers::StreamingDelayEstimator(referenceSignal.getChannelView(chNumber - 1),
+                                                                                                     delay_samples - timeTolerance_samples - margin,
+                                                                                                     delay_samples + timeTolerance_samples + margin));
+            }
+        }
+        
+        void process(const ISignal& block)
+        {
+            for (auto& estimator : m_estimators) {
+                estimator.second.process(block.getChannelView(estimator.first - 1)); // channels are 1-based, indices 0-based
+            }
+        }
+        
+        /** @returns true if the remaining blocks cannot change the result */
+        bool isDecided() const { return false; }
+        bool finish()
+        {
+            for (auto& estimator : m_estimators) {
+                if (!isWithinTolerance(estimator.second.getEstimate(), m_delay, m_timeTolerance, m_minCorrelation)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        
+    private:
+        int m_delay;
+        int m_timeTolerance;
+        float m_minCorrelation;
+        std::vector<std::pair<int, FrequencyDomainHelpers::StreamingDelayEstimator>> m_estimators;
+    };
+    
+private:
+    static bool isWithinTolerance(const DelayEstimate& estimate, int delay_samples, int timeTolerance_samples, float minCorrelation)
     {
-        return HasSignalOnlyInBands::eval(signal, selectedChannels, Freqs{{frequency, sampleRate/2}}, sampleRate, threshold_dB);
+        return estimate.correlation >= minCorrelation && std::abs(estimate.delay_samples - delay_samples) <= timeTolerance_samples;
     }
 };
 
@@ -9,12 +9,24 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
 #include <set>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "ChannelSelection.hpp"
+#include "Execution.hpp"
 #include "FrequencySelection.hpp"
+#include "Kernels.hpp"
+#include "SampleTypes.hpp"
 #include "SignalAdapters.hpp"
+#include "StaticSignal.hpp"
 
 #include "AudioTraits-FD.hpp"
 
@@ -22,36 +34,87 @@ namespace slb {
 namespace AudioTraits {
 
 // MARK: - Infrastructure
-template<typename F, typename ... Is>
-static bool check(const ISignal& signal, const ChannelSelection& channelSelection, Is&& ... traitParams)
+/** @returns the selected channels (1-based) of a signal with numChannels -- an empty selection means all channels */
+static inline std::set<int> resolveChannelSelection(int numChannels, const ChannelSelection& channelSelection)
 {
-    SLB_ASSERT(signal.getNumSamples() > 0);
     std::set<int> selectedChannels = channelSelection.get();
-    SLB_ASSERT(selectedChannels.size() <= signal.getNumChannels());
-    std::for_each(selectedChannels.begin(), selectedChannels.end(), [&signal](auto& i) { SLB_ASSERT(i<=signal.getNumChannels()); });
+    SLB_ASSERT(selectedChannels.size() <= numChannels);
+    std::for_each(selectedChannels.begin(), selectedChannels.end(), [numChannels](auto& i) { SLB_ASSERT(i<=numChannels); });
 
     // Empty selection means all channels
     if (selectedChannels.empty()) {
         std::set<int>::iterator it = selectedChannels.end();
-        for (int i=1; i <= signal.getNumChannels(); ++i) {
+        for (int i=1; i <= numChannels; ++i) {
            it = selectedChannels.insert(it, i);
         }
     }
-    
+    return selectedChannels;
+}
+
+/** @returns the selected channels (1-based) -- an empty selection means all channels */
+static inline std::set<int> resolveChannelSelection(const ISignal& signal, const ChannelSelection& channelSelection)
+{
+    SLB_ASSERT(signal.getNumSamples() > 0);
+    return resolveChannelSelection(signal.getNumChannels(), channelSelection);
+}
+
+template<typename F, typename ... Is>
+static bool check(const ISignal& signal, const ChannelSelection& channelSelection, Is&& ... traitParams)
+{
+    std::set<int> selectedChannels = resolveChannelSelection(signal, channelSelection);
     return F::eval(signal, selectedChannels, std::forward<decltype(traitParams)>(traitParams)...);
 }
 
+/**
+ * Evaluates the trait on a signal with a compile-time layout (see StaticSignal). Traits whose eval() is a template on
+ * the signal type (like the time-domain traits) are instantiated for it, so channel access needs no virtual dispatch.
+ */
+template<typename F, typename L, typename ... Is>
+static bool check(const StaticSignal<L, float>& signal, const ChannelSelection& channelSelection, Is&& ... traitParams)
+{
+    std::set<int> selectedChannels = resolveChannelSelection(signal, channelSelection);
+    return F::eval(signal, selectedChannels, std::forward<decltype(traitParams)>(traitParams)...);
+}
+
+template<typename F, typename ... Is>
+static bool check(const exec::sequenced_policy& /*policy*/, const ISignal& signal, const ChannelSelection& channelSelection, Is&& ... traitParams)
+{
+    return check<F>(signal, channelSelection, std::forward<decltype(traitParams)>(traitParams)...);
+}
+
+/**
+ * Evaluates the trait with the selected channels spread across several threads, e.g. check<F>(exec::parallel, ...).
+ * Only channel-separable traits (see IsChannelSeparable) are parallelized, others are evaluated sequentially.
+ * @note The signal (and any other parameters) are accessed from several threads at once.
+ */
+template<typename F, typename ... Is>
+static bool check(const exec::parallel_policy& policy, const ISignal& signal, const ChannelSelection& channelSelection, Is&& ... traitParams)
+{
+    std::set<int> selectedChannels = resolveChannelSelection(signal, channelSelection);
+    return Execution::evaluate<F>(policy, IsChannelSeparable<F>{}, signal, selectedChannels, traitParams...);
+}
+
+/**
+ * @returns true if a >= b (taking into account tolerance [dB])
+ * @note the tolerance is converted to a linear ratio once, so the sample comparisons need no logarithms.
+ */
+static inline bool areVectorsEqual(const ChannelView& a, const ChannelView& b, float tolerance_dB)
+{
+    SLB_ASSERT(a.size() == b.size(), "Vectors must be of equal length for comparison");
+    return Kernels::areMagnitudesWithinRatio(a, b, Utils::dB2Linear(tolerance_dB));
+}
+
 /** @returns true if a >= b (taking into account tolerance [dB]) */
 static inline bool areVectorsEqual(const std::vector<float>& a, const std::vector<float>& b, float tolerance_dB)
 {
-    SLB_ASSERT(a.size() == b.size(), "Vectors must be of equal length for comparison");
-    return std::equal(a.begin(), a.end(), b.begin(), [&tolerance_dB](float v1, float v2)
-    {
-        float error = std::abs(Utils::linear2Db(std::abs(v1)) - Utils::linear2Db(std::abs(v2)));
-        return error <= tolerance_dB;
-    });
-};
+    return areVectorsEqual(ChannelView(a.data(), static_cast<int>(a.size())), ChannelView(b.data(), static_cast<int>(b.size())), tolerance_dB);
+}
 
+/** @returns true if all samples are zero -- no (finite) tolerance in dB can make a non-zero sample match silence */
+static inline bool isSilent(const ChannelView& a)
+{
+    return !Kernels::containsAbsValueAtLeast(a, std::numeric_limits<float>::denorm_min());
+}
 
 // MARK: - Audio Traits
 
@@ -60,20 +123,46 @@ static inline bool areVectorsEqual(const std::vector<float>& a, const std::vecto
  */
 struct HasSignalOnAllChannels
 {
-    static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, float threshold_dB = -96.f)
+    using ChannelSeparable = std::true_type;
+    
+    template<typename S>
+    static bool eval(const S& signal, const std::set<int>& selectedChannels, float threshold_dB = -96.f)
     {
         const float threshold_linear = Utils::dB2Linear(threshold_dB);
         for (int chNumber : selectedChannels) {
-            auto channelSignal = signal.getChannelDataCopy(chNumber - 1); // channels are 1-based, indices 0-based
-            // find absolute max sample in channel signal
-            auto minmax = std::minmax_element(channelSignal.begin(), channelSignal.end());
-            float absmax = std::max(std::abs(*std::get<0>(minmax)), *std::get<1>(minmax));
-            if (absmax < threshold_linear) {
+            ChannelView channelSignal = signal.getChannelView(chNumber - 1); // channels are 1-based, indices 0-based
+            // look for a sample whose absolute value reaches the threshold (vectorized, stops at the first one)
+            if (!Kernels::containsAbsValueAtLeast(channelSignal, threshold_linear)) {
                 return false; // one channel without signal is enough to fail
             }
         }
         return true;
     }
+    
+    /** Block-wise evaluation: process() consecutive blocks of the signal, then finish() */
+    class Accumulator
+    {
+    public:
+        explicit Accumulator(const std::set<int>& selectedChannels, float threshold_dB = -96.f) :
+            m_threshold_linear(Utils::dB2Linear(threshold_dB)),
+            m_channelsWithoutSignal(selectedChannels) {}
+        
+        void process(const ISignal& block)
+        {
+            for (auto it = m_channelsWithoutSignal.begin(); it != m_channelsWithoutSignal.end(); ) {
+                const bool hasSignal = Kernels::containsAbsValueAtLeast(block.getChannelView(*it - 1), m_threshold_linear);
+                it = hasSignal ? m_channelsWithoutSignal.erase(it) : std::next(it);
+            }
+        }
+        
+        /** @returns true if the remaining blocks cannot change the result */
+        bool isDecided() const { return m_channelsWithoutSignal.empty(); }
+        bool finish() const { return m_channelsWithoutSignal.empty(); }
+        
+    private:
+        float m_threshold_linear;
+        std::set<int> m_channelsWithoutSignal;
+    };
 };
 
 /**
@@ -86,7 +175,10 @@ struct HasSignalOnAllChannels
  */
 struct IsDelayedVersionOf
 {
-    static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, const ISignal& referenceSignal,
+    using ChannelSeparable = std::true_type;
+    
+    template<typename S>
+    static bool eval(const S& signal, const std::set<int>& selectedChannels, const ISignal& referenceSignal,
                      int delay_samples, float amplitudeTolerance_dB = 0.f, int timeTolerance_samples = 0)
     {
         SLB_ASSERT(delay_samples >= 0, "The delay must be positive");
@@ -96,8 +188,8 @@ struct IsDelayedVersionOf
         SLB_ASSERT(referenceSignal.getNumSamples() >= signal.getNumSamples() - delay_samples, "The reference signal is not long enough");
 
         for (int chNumber : selectedChannels) {
-            std::vector<float> channelSignal = signal.getChannelDataCopy(chNumber - 1); // channels are 1-based, indices 0-based
-            std::vector<float> channelSignalRef = referenceSignal.getChannelDataCopy(chNumber - 1); // channels are 1-based, indices 0-based
+            ChannelView channelSignal = signal.getChannelView(chNumber - 1); // channels are 1-based, indices 0-based
+            ChannelView channelSignalRef = referenceSignal.getChannelView(chNumber - 1); // channels are 1-based, indices 0-based
 
             bool thisChannelPassed = false;
             
@@ -105,19 +197,9 @@ struct IsDelayedVersionOf
             // Try to match signal with all delay values in this range
             const int& error = timeTolerance_samples;
             for (int jitteredDelay = delay_samples - error; jitteredDelay <= delay_samples + error; ++jitteredDelay) {
-                std::vector<float> delayedRef;
-                if (jitteredDelay < 0) {
-                    // negative delay: we delay the signal instead of the reference
-                    delayedRef = channelSignal;
-                } else {
-                    delayedRef = channelSignalRef;
-                }
-                // delay the copy we made
-                std::vector<float> zeroPadding(std::abs(jitteredDelay), 0);
-                delayedRef.insert(delayedRef.begin(), zeroPadding.begin(), zeroPadding.end());
-                delayedRef.resize(channelSignal.size());
-                
-                if (areVectorsEqual(channelSignal, delayedRef, amplitudeTolerance_dB)) {
+                // negative delay: we delay the signal instead of the reference
+                const ChannelView& delayedRef = (jitteredDelay < 0) ? channelSignal : channelSignalRef;
+                if (isDelayedVersionOf(channelSignal, delayedRef, std::abs(jitteredDelay), amplitudeTolerance_dB)) {
                     thisChannelPassed = true; // We found a match for this channel
                     break;
                 }
@@ -128,7 +210,149 @@ struct IsDelayedVersionOf
         }
         return true;
     }
-  
+    
+    /**
+     * Block-wise evaluation: process() consecutive blocks of the signal, then finish().
+     * The reference signal is held by reference and must be fully available.
+     */
+    class Accumulator
+    {
+    public:
+        Accumulator(const std::set<int>& selectedChannels, const ISignal& referenceSignal, int delay_samples,
+                    float amplitudeTolerance_dB = 0.f, int timeTolerance_samples = 0) :
+            m_selectedChannels(selectedChannels),
+            m_referenceSignal(referenceSignal),
+            m_delay(delay_samples),
+            m_timeTolerance(timeTolerance_samples),
+            m_maxRatio(Utils::dB2Linear(amplitudeTolerance_dB)),
+            m_historySize(std::max(0, timeTolerance_samples - delay_samples))
+        {
+            SLB_ASSERT(delay_samples >= 0, "The delay must be positive");
+            SLB_ASSERT(amplitudeTolerance_dB >= 0 && amplitudeTolerance_dB < 96.f, "Invalid amplitude tolerance");
+            SLB_ASSERT(timeTolerance_samples >= 0 && timeTolerance_samples <= 5, "Time tolerance has to be between 0 and 5 samples");
+            
+            // every selected channel starts with all 'jittered' delay times as candidates
+            for (int chNumber : selectedChannels) {
+                m_isCandidate[chNumber].assign(2 * timeTolerance_samples + 1, true);
+                m_history[chNumber].reserve(m_historySize);
+            }
+        }
+        
+        void process(const ISignal& block)
+        {
+            if (m_hasFailed) {
+                return;
+            }
+            for (int chNumber : m_selectedChannels) {
+                const ChannelView channelBlock = block.getChannelView(chNumber - 1); // channels are 1-based, indices 0-based
+                const ChannelView channelRef = m_referenceSignal.getChannelView(chNumber - 1);
+                std::vector<bool>& isCandidate = m_isCandidate[chNumber];
+                bool hasCandidate = false;
+                for (int i = 0; i < static_cast<int>(isCandidate.size()); ++i) {
+                    const int jitteredDelay = m_delay - m_timeTolerance + i;
+                    if (isCandidate[i]) {
+                        isCandidate[i] = (jitteredDelay < 0) ? matchesDelayedSelf(channelBlock, m_history[chNumber], -jitteredDelay)
+                                                             : matchesDelayedReference(channelBlock, channelRef, jitteredDelay);
+                        hasCandidate = hasCandidate || isCandidate[i];
+                    }
+                }
+                if (!hasCandidate) {
+                    m_hasFailed = true; // none of the 'jittered' delay times is a match for this channel
+                    return;
+                }
+                updateHistory(m_history[chNumber], channelBlock);
+            }
+            m_position += block.getNumSamples();
+        }
+        
+        /** @returns true if the remaining blocks cannot change the result */
+        bool isDecided() const { return m_hasFailed; }
+        bool finish() const
+        {
+            SLB_ASSERT(m_hasFailed || (static_cast<float>(m_delay)/static_cast<float>(m_position)) < .8f, "The delay cannot be longer than 80% of the signal");
+            SLB_ASSERT(m_hasFailed || m_referenceSignal.getNumSamples() >= m_position - m_delay, "The reference signal is not long enough");
+            return !m_hasFailed;
+        }
+        
+    private:
+        /** Compares the block (at the current position) with the delayed reference -- see isDelayedVersionOf() */
+        bool matchesDelayedReference(const ChannelView& block, const ChannelView& reference, int delay) const
+        {
+            const int numSamples = block.size();
+            const int leadingZeros = static_cast<int>(std::min<std::int64_t>(std::max<std::int64_t>(delay - m_position, 0), numSamples));
+            const int referenceStart = static_cast<int>(std::min<std::int64_t>(std::max<std::int64_t>(m_position + leadingZeros - delay, 0),
+                                                                               reference.size()));
+            const int overlap = std::min(reference.size() - referenceStart, numSamples - leadingZeros);
+            const int trailingZeros = numSamples - leadingZeros - overlap;
+            
+            return isSilent(block.subView(0, leadingZeros))
+                && Kernels::areMagnitudesWithinRatio(block.subView(leadingZeros, overlap), reference.subView(referenceStart, overlap), m_maxRatio)
+                && isSilent(block.subView(leadingZeros + overlap, trailingZeros));
+        }
+        
+        /** Compares the block (at the current position) with the signal itself, delayed by 'delay' samples */
+        bool matchesDelayedSelf(const ChannelView& block, const std::vector<float>& history, int delay) const
+        {
+            const int numSamples = block.size();
+            const int leadingZeros = static_cast<int>(std::min<std::int64_t>(std::max<std::int64_t>(delay - m_position, 0), numSamples));
+            if (!isSilent(block.subView(0, leadingZeros))) {
+                return false;
+            }
+            // the first samples are compared with the end of the previous block(s)
+            const int historyEnd = std::max(leadingZeros, std::min(delay, numSamples));
+            const int historySize = static_cast<int>(history.size());
+            for (int i = leadingZeros; i < historyEnd; ++i) {
+                const float previous = history[historySize - delay + i];
+                if (!Kernels::Scalar::areMagnitudesWithinRatio(&block[i], 1, &previous, 1, 1, m_maxRatio)) {
+                    return false;
+                }
+            }
+            if (historyEnd == numSamples) {
+                return true;
+            }
+            return Kernels::areMagnitudesWithinRatio(block.subView(historyEnd, numSamples - historyEnd),
+                                                     block.subView(historyEnd - delay, numSamples - historyEnd), m_maxRatio);
+        }
+        
+        /** Keeps the last samples of the signal, for the comparison with itself (negative jittered delays) */
+        void updateHistory(std::vector<float>& history, const ChannelView& block) const
+        {
+            const int numNewSamples = std::min(block.size(), m_historySize);
+            const int numToDrop = std::max(0, static_cast<int>(history.size()) + numNewSamples - m_historySize);
+            history.erase(history.begin(), history.begin() + numToDrop);
+            for (int i = block.size() - numNewSamples; i < block.size(); ++i) {
+                history.push_back(block[i]);
+            }
+        }
+        
+        std::set<int> m_selectedChannels;
+        const ISignal& m_referenceSignal;
+        int m_delay;
+        int m_timeTolerance;
+        float m_maxRatio;
+        int m_historySize;
+        std::map<int, std::vector<bool>> m_isCandidate; // per channel and jittered delay
+        std::map<int, std::vector<float>> m_history;    // per channel
+        std::int64_t m_position = 0; // streams can be longer than 2^31 samples
+        bool m_hasFailed = false;
+    };
+    
+private:
+    /**
+     * Compares the signal with a version of the reference which is delayed by zero-padding at the start and
+     * zero-padded/truncated at the end to match the signal's length -- without actually creating that version.
+     */
+    static bool isDelayedVersionOf(const ChannelView& signal, const ChannelView& reference, int delay, float amplitudeTolerance_dB)
+    {
+        const int numSamples = signal.size();
+        const int leadingZeros = std::min(delay, numSamples);
+        const int overlap = std::min(numSamples - leadingZeros, reference.size());
+        const int trailingZeros = numSamples - leadingZeros - overlap;
+        
+        return isSilent(signal.subView(0, leadingZeros))
+            && areVectorsEqual(signal.subView(leadingZeros, overlap), reference.subView(0, overlap), amplitudeTolerance_dB)
+            && isSilent(signal.subView(leadingZeros + overlap, trailingZeros));
+    }
 };
 
 /**
@@ -139,24 +363,77 @@ struct IsDelayedVersionOf
  */
 struct HasIdenticalChannels
 {
-    static bool eval(const ISignal& signal, const std::set<int>& selectedChannels, float tolerance_dB = 0.f)
+    template<typename S>
+    static bool eval(const S& signal, const std::set<int>& selectedChannels, float tolerance_dB = 0.f)
     {
         SLB_ASSERT(tolerance_dB >= 0 && tolerance_dB < 96.f, "Invalid amplitude tolerance");
         
-        bool doAllChannelsMatch = true;
-        std::vector<float> reference(0); // init with size 0
+        if (selectedChannels.empty()) {
+            return true;
+        }
+        
+        const float maxRatio = Utils::dB2Linear(tolerance_dB);
+        const int referenceChannelNumber = *selectedChannels.begin(); // Take first channel as reference
+        const ChannelView reference = signal.getChannelView(referenceChannelNumber - 1);
+        std::vector<ChannelView> channels;
+        channels.reserve(selectedChannels.size() - 1);
         for (int chNumber : selectedChannels) {
-            std::vector<float> channelSignal = signal.getChannelDataCopy(chNumber - 1); // channels are 1-based, indices 0-based
-            if (reference.empty()) {
-                reference = channelSignal; // Take first channel as reference
-                continue; // no comparison with itself
+            if (chNumber != referenceChannelNumber) { // no comparison with itself
+                channels.push_back(signal.getChannelView(chNumber - 1)); // channels are 1-based, indices 0-based
             }
-            doAllChannelsMatch = areVectorsEqual(channelSignal, reference, tolerance_dB);
         }
         
-        return doAllChannelsMatch;
+        // Walk through all channels in lockstep, one block at a time: the reference block stays in cache while it is
+        // compared to all other channels, and the first mismatch ends the evaluation.
+        const int numSamples = reference.size();
+        for (int blockStart = 0; blockStart < numSamples; blockStart += evaluationBlockSize) {
+            const int blockLength = std::min(evaluationBlockSize, numSamples - blockStart);
+            const ChannelView referenceBlock = reference.subView(blockStart, blockLength);
+            for (const ChannelView& channel : channels) {
+                if (!Kernels::areMagnitudesWithinRatio(channel.subView(blockStart, blockLength), referenceBlock, maxRatio)) {
+                    return false;
+                }
+            }
+        }
+        return true;
     }
-  
+    
+    /** Block-wise evaluation: process() consecutive blocks of the signal, then finish() */
+    class Accumulator
+    {
+    public:
+        explicit Accumulator(const std::set<int>& selectedChannels, float tolerance_dB = 0.f) :
+            m_selectedChannels(selectedChannels),
+            m_maxRatio(Utils::dB2Linear(tolerance_dB))
+        {
+            SLB_ASSERT(tolerance_dB >= 0 && tolerance_dB < 96.f, "Invalid amplitude tolerance");
+        }
+        
+        void process(const ISignal& block)
+        {
+            if (m_hasFailed || m_selectedChannels.empty()) {
+                return;
+            }
+            const int referenceChannelNumber = *m_selectedChannels.begin(); // Take first channel as reference
+            const ChannelView referenceBlock = block.getChannelView(referenceChannelNumber - 1);
+            for (int chNumber : m_selectedChannels) {
+                if (chNumber != referenceChannelNumber &&
+                    !Kernels::areMagnitudesWithinRatio(block.getChannelView(chNumber - 1), referenceBlock, m_maxRatio)) {
+                    m_hasFailed = true;
+                    return;
+                }
+            }
+        }
+        
+        /** @returns true if the remaining blocks cannot change the result */
+        bool isDecided() const { return m_hasFailed; }
+        bool finish() const { return !m_hasFailed; }
+        
+    private:
+        std::set<int> m_selectedChannels;
+        float m_maxRatio;
+        bool m_hasFailed = false;
+    };
 };
 
 /**
@@ -167,20 +444,341 @@ struct HasIdenticalChannels
  */
 struct HaveIdenticalChannels
 {
-    static bool eval(const ISignal& signalA, const std::set<int>& selectedChannels, const ISignal& signalB, float tolerance_dB = 0.f)
+    using ChannelSeparable = std::true_type;
+    
+    template<typename S>
+    static bool eval(const S& signalA, const std::set<int>& selectedChannels, const ISignal& signalB, float tolerance_dB = 0.f)
     {
         SLB_ASSERT(tolerance_dB >= 0 && tolerance_dB < 96.f, "Invalid amplitude tolerance");
         
         for (int chNumber : selectedChannels) {
-            std::vector<float> channelSignalA = signalA.getChannelDataCopy(chNumber - 1); // channels are 1-based, indices 0-based
-            std::vector<float> channelSignalB = signalB.getChannelDataCopy(chNumber - 1); // channels are 1-based, indices 0-based
+            ChannelView channelSignalA = signalA.getChannelView(chNumber - 1); // channels are 1-based, indices 0-based
+            ChannelView channelSignalB = signalB.getChannelView(chNumber - 1); // channels are 1-based, indices 0-based
             if (!areVectorsEqual(channelSignalA, channelSignalB, tolerance_dB)) {
                 return false; // one channel without a match is enough to fail
             }
         }
         return true;
     }
+    
+    /** Block-wise evaluation: process() consecutive blocks of signal A, then finish() */
+    class Accumulator
+    {
+    public:
+        explicit Accumulator(const std::set<int>& selectedChannels, const ISignal& signalB, float tolerance_dB = 0.f) :
+            m_selectedChannels(selectedChannels),
+            m_signalB(signalB),
+            m_maxRatio(Utils::dB2Linear(tolerance_dB))
+        {
+            SLB_ASSERT(tolerance_dB >= 0 && tolerance_dB < 96.f, "Invalid amplitude tolerance");
+        }
+        
+        void process(const ISignal& blockA)
+        {
+            const int blockLength = blockA.getNumSamples();
+            SLB_ASSERT(m_position + blockLength <= m_signalB.getNumSamples(), "Vectors must be of equal length for comparison");
+            for (int chNumber : m_selectedChannels) {
+                if (m_hasFailed) {
+                    break;
+                }
+                ChannelView channelBlockB = m_signalB.getChannelView(chNumber - 1).subView(static_cast<int>(m_position), blockLength);
+                m_hasFailed = !Kernels::areMagnitudesWithinRatio(blockA.getChannelView(chNumber - 1), channelBlockB, m_maxRatio);
+            }
+            m_position += blockLength;
+        }
+        
+        /** @returns true if the remaining blocks cannot change the result */
+        bool isDecided() const { return m_hasFailed; }
+        bool finish() const
+        {
+            SLB_ASSERT(m_hasFailed || m_position == m_signalB.getNumSamples(), "Vectors must be of equal length for comparison");
+            return !m_hasFailed;
+        }
+        
+    private:
+        std::set<int> m_selectedChannels;
+        const ISignal& m_signalB;
+        float m_maxRatio;
+        std::int64_t m_position = 0;
+        bool m_hasFailed = false;
+    };
+};
+
+// MARK: - Batch Evaluation
+
+/** A trait together with its parameters, to be evaluated later -- see bind() and checkAll() */
+template<typename F, typename ... Ps>
+class BoundTrait
+{
+public:
+    using Trait = F;
+    
+    template<typename ... Args>
+    explicit BoundTrait(Args&& ... params) : m_params(std::forward<Args>(params)...) {}
+    
+    bool eval(const ISignal& signal, const std::set<int>& selectedChannels) const
+    {
+        return evalImpl(signal, selectedChannels, std::index_sequence_for<Ps...>{});
+    }
+    
+    /** Creates the trait's Accumulator with the bound parameters (only for traits that have one) */
+    template<typename T = F>
+    typename T::Accumulator makeAccumulator(const std::set<int>& selectedChannels) const
+    {
+        return makeAccumulatorImpl<T>(selectedChannels, std::index_sequence_for<Ps...>{});
+    }
+    
+private:
+    template<std::size_t ... I>
+    bool evalImpl(const ISignal& signal, const std::set<int>& selectedChannels, std::index_sequence<I...>) const
+    {
+        return F::eval(signal, selectedChannels, std::get<I>(m_params)...);
+    }
+    
+    template<typename T, std::size_t ... I>
+    typename T::Accumulator makeAccumulatorImpl(const std::set<int>& selectedChannels, std::index_sequence<I...>) const
+    {
+        return typename T::Accumulator(selectedChannels, std::get<I>(m_params)...);
+    }
+    
+    // l-values are stored by reference, r-values by value
+    std::tuple<Ps...> m_params;
+};
+
+/**
+ * Binds parameters to a trait, e.g. bind<HasSignalOnAllChannels>(-40.f).
+ * @note parameters passed as l-values are referenced, so they have to outlive the returned object.
+ */
+template<typename F, typename ... Ps>
+static BoundTrait<F, Ps...> bind(Ps&& ... traitParams)
+{
+    return BoundTrait<F, Ps...>(std::forward<Ps>(traitParams)...);
+}
+
+template<typename F, typename = void>
+struct HasAccumulator : std::false_type {};
+
+template<typename F>
+struct HasAccumulator<F, typename MakeVoid<typename F::Accumulator>::type> : std::true_type {};
+
+/** Frequency-domain traits are tagged with: using FrequencyDomain = std::true_type; */
+template<typename F, typename = void>
+struct IsFrequencyDomainTrait : std::false_type {};
+
+template<typename F>
+struct IsFrequencyDomainTrait<F, typename MakeVoid<typename F::FrequencyDomain>::type> : F::FrequencyDomain {};
+
+namespace BatchEvaluation
+{
+/**
+ * Time-domain traits with an accumulator are evaluated in the fused pass. Frequency-domain traits are evaluated on the
+ * whole signal instead, so they can share the spectra.
+ */
+template<typename F>
+using IsEvaluatedBlockwise = std::integral_constant<bool, HasAccumulator<F>::value && !IsFrequencyDomainTrait<F>::value>;
+
+/** true if any of the traits is a frequency-domain trait, i.e. the spectra are worth sharing */
+template<typename ... Fs>
+struct HasFrequencyDomainTrait : std::false_type {};
+
+template<typename F, typename ... Fs>
+struct HasFrequencyDomainTrait<F, Fs...> : std::integral_constant<bool, IsFrequencyDomainTrait<F>::value || HasFrequencyDomainTrait<Fs...>::value> {};
+
+/** Adds the accumulators of all bound traits that are evaluated block-wise */
+template<typename B>
+static void addAccumulator(std::vector<std::function<bool(const ISignal*)>>&, const B&, const std::set<int>&, bool&,
+                           std::false_type /*isEvaluatedBlockwise*/) {}
+
+template<typename B>
+static void addAccumulator(std::vector<std::function<bool(const ISignal*)>>& accumulators, const B& boundTrait,
+                           const std::set<int>& selectedChannels, bool& result, std::true_type /*isEvaluatedBlockwise*/)
+{
+    // The function processes a block (and returns true if the result is decided), or finishes if there is no block
+    auto accumulator = std::make_shared<typename B::Trait::Accumulator>(boundTrait.makeAccumulator(selectedChannels));
+    accumulators.emplace_back([accumulator, &result](const ISignal* block)
+    {
+        if (block == nullptr) {
+            result = accumulator->finish();
+            return true;
+        }
+        accumulator->process(*block);
+        return accumulator->isDecided();
+    });
+}
+
+/** Evaluates a bound trait that is not evaluated block-wise on the (analyzed) signal */
+template<typename B>
+static void evalWithoutAccumulator(const B& boundTrait, const ISignal& signal, const std::set<int>& selectedChannels,
+                                   bool& result, std::false_type /*isEvaluatedBlockwise*/)
+{
+    result = boundTrait.eval(signal, selectedChannels);
+}
+
+template<typename B>
+static void evalWithoutAccumulator(const B&, const ISignal&, const std::set<int>&, bool&, std::true_type /*isEvaluatedBlockwise*/) {}
+} // namespace BatchEvaluation
+
+/**
+ * Evaluates several traits on the same signal and channel selection, e.g.
+ *
+ *     checkAll(signal, {}, bind<HasSignalOnAllChannels>(), bind<HasSignalOnlyBelow>(4000.f, sampleRate));
+ *
+ * Time-domain traits with an Accumulator are evaluated together, in a single pass over the signal that ends as
+ * soon as all of their results are decided. The other traits share one spectral analysis of every channel.
+ *
+ * @returns the result of every trait, in the order they were passed
+ */
+template<typename ... Bs>
+static std::array<bool, sizeof...(Bs)> checkAll(const ISignal& signal, const ChannelSelection& channelSelection, const Bs& ... boundTraits)
+{
+    const std::set<int> selectedChannels = resolveChannelSelection(signal, channelSelection);
+    std::array<bool, sizeof...(Bs)> results {};
+    
+    // Time-domain traits: one pass over the signal, block by block
+    std::vector<std::function<bool(const ISignal*)>> accumulators;
+    int traitIndex = 0;
+    static_cast<void>(std::initializer_list<int>{ (BatchEvaluation::addAccumulator(accumulators, boundTraits, selectedChannels, results[traitIndex++],
+                                                                                   BatchEvaluation::IsEvaluatedBlockwise<typename Bs::Trait>{}), 0)... });
+    std::vector<bool> isDecided(accumulators.size(), false);
+    int numUndecided = static_cast<int>(accumulators.size());
+    for (int blockStart = 0; blockStart < signal.getNumSamples() && numUndecided > 0; blockStart += evaluationBlockSize) {
+        const int blockLength = std::min(evaluationBlockSize, signal.getNumSamples() - blockStart);
+        const SignalAdapterChannelViews block = getSignalBlock(signal, blockStart, blockLength);
+        for (int i = 0; i < static_cast<int>(accumulators.size()); ++i) {
+            if (!isDecided[i] && accumulators[i](&block)) {
+                isDecided[i] = true;
+                --numUndecided;
+            }
+        }
+    }
+    for (auto& accumulator : accumulators) {
+        accumulator(nullptr);
+    }
+    
+    // All other traits: share the spectra -- only needed for frequency-domain traits, and if the signal is not an
+    // AnalyzedSignal already
+    std::unique_ptr<const AnalyzedSignal> localAnalyzedSignal;
+    if (BatchEvaluation::HasFrequencyDomainTrait<typename Bs::Trait...>::value && dynamic_cast<const AnalyzedSignal*>(&signal) == nullptr) {
+        localAnalyzedSignal.reset(new AnalyzedSignal(signal));
+    }
+    const ISignal& sharedSignal = localAnalyzedSignal ? static_cast<const ISignal&>(*localAnalyzedSignal) : signal;
+    traitIndex = 0;
+    static_cast<void>(std::initializer_list<int>{ (BatchEvaluation::evalWithoutAccumulator(boundTraits, sharedSignal, selectedChannels, results[traitIndex++],
+                                                                                           BatchEvaluation::IsEvaluatedBlockwise<typename Bs::Trait>{}), 0)... });
+    return results;
+}
+
+// MARK: - Streaming Evaluation
+
+/**
+ * Evaluates a trait on a signal that is passed in consecutive blocks, e.g. straight from an audio callback or a file
+ * reader. Only the trait's Accumulator state is kept, not the signal:
+ *
+ *     StreamingCheck<HasSignalOnAllChannels> streamingCheck;
+ *     streamingCheck.begin(numChannels, {1, 2}, -40.f);
+ *     while (...) { streamingCheck.process(block); }
+ *     bool result = streamingCheck.finish();
+ *
+ * The trait parameters are the same as for check<F>(). Time-domain traits hold O(block) state; frequency-domain traits
+ * hold one FFT frame per channel. Traits that compare against a reference signal still need the reference in memory.
+ */
+template<typename F>
+class StreamingCheck
+{
+    static_assert(HasAccumulator<F>::value, "This trait does not support streaming evaluation");
+    
+public:
+    /** Starts a new evaluation (discarding any previous one) for a signal with numChannels */
+    template<typename ... Is>
+    void begin(int numChannels, const ChannelSelection& channelSelection, Is&& ... traitParams)
+    {
+        SLB_ASSERT(numChannels > 0, "invalid number of channels");
+        m_numChannels = numChannels;
+        m_hasSamples = false;
+        m_accumulator.reset(new typename F::Accumulator(resolveChannelSelection(numChannels, channelSelection),
+                                                        std::forward<decltype(traitParams)>(traitParams)...));
+    }
+    
+    /** Processes the next block of the signal -- blocks can be of any length */
+    void process(const ISignal& block)
+    {
+        SLB_ASSERT(m_accumulator != nullptr, "begin() has to be called first");
+        SLB_ASSERT(block.getNumChannels() == m_numChannels, "The number of channels cannot change");
+        m_hasSamples = m_hasSamples || block.getNumSamples() > 0;
+        if (!m_accumulator->isDecided()) {
+            m_accumulator->process(block);
+        }
+    }
+    
+    /** @returns true if the remaining blocks cannot change the result, i.e. processing can stop early */
+    bool isDecided() const
+    {
+        SLB_ASSERT(m_accumulator != nullptr, "begin() has to be called first");
+        return m_accumulator->isDecided();
+    }
+    
+    /** @returns the result of the trait for all blocks passed since begin(). Call begin() again for a new evaluation. */
+    bool finish()
+    {
+        SLB_ASSERT(m_accumulator != nullptr, "begin() has to be called first");
+        SLB_ASSERT(m_hasSamples);
+        std::unique_ptr<typename F::Accumulator> accumulator = std::move(m_accumulator);
+        return accumulator->finish();
+    }
+    
+private:
+    std::unique_ptr<typename F::Accumulator> m_accumulator;
+    int m_numChannels = 0;
+    bool m_hasSamples = false;
 };
 
+namespace StreamingEvaluation
+{
+/** Converts the signal block by block into a small float buffer and evaluates the trait on the blocks */
+template<typename F, typename L, typename T, typename ... Is>
+static bool evaluateConverted(std::true_type /*hasAccumulator*/, const StaticSignal<L, T>& signal, const ChannelSelection& channelSelection,
+                              Is&& ... traitParams)
+{
+    SLB_ASSERT(signal.getNumSamples() > 0);
+    const int numChannels = signal.getNumChannels();
+    StreamingCheck<F> streamingCheck;
+    streamingCheck.begin(numChannels, channelSelection, std::forward<decltype(traitParams)>(traitParams)...);
+    
+    std::vector<float> blockBuffer(numChannels * evaluationBlockSize);
+    for (int blockStart = 0; blockStart < signal.getNumSamples() && !streamingCheck.isDecided(); blockStart += evaluationBlockSize) {
+        const int blockLength = std::min(evaluationBlockSize, signal.getNumSamples() - blockStart);
+        std::vector<ChannelView> channelViews;
+        channelViews.reserve(numChannels);
+        for (int channelIndex = 0; channelIndex < numChannels; ++channelIndex) {
+            float* channelBlock = blockBuffer.data() + channelIndex * evaluationBlockSize;
+            convertToFloat(signal.getChannelStart(channelIndex) + Utils::stridedOffset(blockStart, signal.getStride()), signal.getStride(),
+                           blockLength, channelBlock);
+            channelViews.emplace_back(channelBlock, blockLength);
+        }
+        streamingCheck.process(SignalAdapterChannelViews(std::move(channelViews)));
+    }
+    return streamingCheck.finish();
+}
+
+/** Traits without an Accumulator are evaluated on the (converted) channels */
+template<typename F, typename L, typename T, typename ... Is>
+static bool evaluateConverted(std::false_type /*hasAccumulator*/, const StaticSignal<L, T>& signal, const ChannelSelection& channelSelection,
+                              Is&& ... traitParams)
+{
+    std::set<int> selectedChannels = resolveChannelSelection(signal, channelSelection);
+    return F::eval(signal, selectedChannels, std::forward<decltype(traitParams)>(traitParams)...);
+}
+} // namespace StreamingEvaluation
+
+/**
+ * Evaluates the trait on a signal with a sample type other than float (see StaticSignal). Traits with an Accumulator
+ * are evaluated block by block on converted blocks, so the signal is never converted as a whole.
+ */
+template<typename F, typename L, typename T, typename ... Is>
+static bool check(const StaticSignal<L, T>& signal, const ChannelSelection& channelSelection, Is&& ... traitParams)
+{
+    return StreamingEvaluation::evaluateConverted<F>(HasAccumulator<F>{}, signal, channelSelection, std::forward<decltype(traitParams)>(traitParams)...);
+}
+
 } // namespace AudioTraits
 } // namespace slb
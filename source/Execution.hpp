@@ -0,0 +1,231 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//  
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <set>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "SignalAdapters.hpp"
+#include "Utils.hpp"
+
+namespace slb {
+namespace AudioTraits {
+
+// MARK: - Execution Policies
+namespace exec
+{
+/** Evaluate the trait on the calling thread (default) */
+struct sequenced_policy {};
+
+/**
+ * Spread the evaluation of the selected channels across several threads (only for channel-separable traits).
+ * @note Every evaluation starts (and joins) its own threads, there is no thread pool: the cost of creating the threads
+ * only pays off if the evaluation of a channel takes considerably longer, e.g. for long signals or FFT-based traits.
+ * If fewer threads can be started than requested, the evaluation continues with the threads that are running.
+ */
+struct parallel_policy
+{
+    /** @param numThreads number of threads to use -- 0 means: as many as there are hardware threads */
+    constexpr explicit parallel_policy(int numThreads = 0) : m_numThreads(numThreads) {}
+    
+    int getNumThreads() const
+    {
+        if (m_numThreads > 0) {
+            return m_numThreads;
+        }
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    
+private:
+    int m_numThreads;
+};
+
+constexpr sequenced_policy sequenced {};
+constexpr parallel_policy parallel {};
+} // namespace exec
+
+// MARK: - Channel separability
+/**
+ * A trait is channel-separable if its result for a set of channels is the logical AND of its results for every single
+ * channel, i.e. channels are evaluated independently of each other. Traits declare this by defining a member type:
+ *
+ *     using ChannelSeparable = std::true_type;
+ *
+ * Only channel-separable traits are evaluated in parallel, all others fall back to sequential evaluation.
+ */
+template<typename...>
+struct MakeVoid { using type = void; };
+
+template<typename F, typename = void>
+struct IsChannelSeparable : std::false_type {};
+
+template<typename F>
+struct IsChannelSeparable<F, typename MakeVoid<typename F::ChannelSeparable>::type> : F::ChannelSeparable {};
+
+namespace Execution
+{
+/**
+ * Owns the worker threads of a parallel evaluation and joins them when it goes out of scope. If that happens while
+ * the threads are still running (i.e. during stack unwinding), the abort flag is raised first, so the workers stop
+ * claiming new work and no thread outlives the state it refers to.
+ */
+template<typename Thread = std::thread>
+class WorkerThreads
+{
+public:
+    WorkerThreads(std::atomic<bool>& abortFlag, int maxNumThreads) : m_abortFlag(abortFlag)
+    {
+        m_threads.reserve(static_cast<size_t>(std::max(0, maxNumThreads)));
+    }
+    
+    ~WorkerThreads()
+    {
+        if (!m_threads.empty()) {
+            m_abortFlag = true;
+            join();
+        }
+    }
+    
+    WorkerThreads(const WorkerThreads&) = delete;
+    WorkerThreads& operator=(const WorkerThreads&) = delete;
+    
+    /** @return false if the thread could not be started (e.g. the system ran out of threads) */
+    template<typename Fn>
+    bool tryStart(const Fn& worker)
+    {
+        SLB_ASSERT(m_threads.size() < m_threads.capacity(), "more threads than reserved");
+#ifdef SLB_EXCEPTIONS_DISABLED
+        m_threads.emplace_back(worker);
+        return true;
+#else
+        try {
+            m_threads.emplace_back(worker); // no reallocation: a throwing constructor leaves the vector unchanged
+            return true;
+        } catch (const std::system_error&) {
+            return false;
+        }
+#endif
+    }
+    
+    void join()
+    {
+        for (auto& thread : m_threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        m_threads.clear();
+    }
+    
+private:
+    std::atomic<bool>& m_abortFlag;
+    std::vector<Thread> m_threads;
+};
+
+/**
+ * Runs the worker on up to numThreads threads, the calling thread included. If fewer threads can be started, the
+ * remaining work is done by the threads that are running -- at least by the calling thread. The worker must return
+ * soon after the abort flag is raised.
+ */
+template<typename Thread = std::thread, typename Fn>
+static void runOnThreads(int numThreads, std::atomic<bool>& abortFlag, const Fn& worker)
+{
+    WorkerThreads<Thread> threads(abortFlag, numThreads - 1);
+    for (int i = 0; i < numThreads - 1; ++i) {
+        if (!threads.tryStart(worker)) {
+            break;
+        }
+    }
+    worker(); // the calling thread contributes as well
+    threads.join();
+}
+
+template<typename F, typename ... Is>
+static bool evaluate(const exec::parallel_policy& /*policy*/, std::false_type /*isChannelSeparable*/,
+                     const ISignal& signal, const std::set<int>& selectedChannels, const Is& ... traitParams)
+{
+    return F::eval(signal, selectedChannels, traitParams...);
+}
+
+/**
+ * Evaluates the trait channel by channel on several threads. The result is the same as for the sequential
+ * evaluation: as soon as one channel fails, the remaining channels are skipped, and the outcome of the lowest channel
+ * that did not pass decides -- false if it failed, its exception is re-thrown if it threw.
+ */
+template<typename F, typename ... Is>
+static bool evaluate(const exec::parallel_policy& policy, std::true_type /*isChannelSeparable*/,
+                     const ISignal& signal, const std::set<int>& selectedChannels, const Is& ... traitParams)
+{
+    const std::vector<int> channels(selectedChannels.begin(), selectedChannels.end());
+    const int numChannels = static_cast<int>(channels.size());
+    const int numThreads = std::min(policy.getNumThreads(), numChannels);
+    if (numThreads <= 1) {
+        return F::eval(signal, selectedChannels, traitParams...);
+    }
+    
+    enum Outcome : char { NotEvaluated, Passed, Failed, Threw };
+    // every channel's outcome is written by exactly one thread, and only read after all threads have been joined
+    std::vector<Outcome> outcomes(numChannels, NotEvaluated);
+#ifndef SLB_EXCEPTIONS_DISABLED
+    std::vector<std::exception_ptr> exceptions(numChannels);
+#endif
+    std::atomic<int> nextChannelIndex { 0 };
+    std::atomic<bool> hasFailed { false };
+    
+    auto worker = [&]()
+    {
+        while (!hasFailed.load()) {
+            // channels are claimed in ascending order: all channels below a failed one are evaluated completely
+            const int channelIndex = nextChannelIndex.fetch_add(1);
+            if (channelIndex >= numChannels) {
+                return;
+            }
+#ifdef SLB_EXCEPTIONS_DISABLED
+            outcomes[channelIndex] = F::eval(signal, std::set<int>{channels[channelIndex]}, traitParams...) ? Passed : Failed;
+#else
+            try {
+                outcomes[channelIndex] = F::eval(signal, std::set<int>{channels[channelIndex]}, traitParams...) ? Passed : Failed;
+            } catch (...) {
+                exceptions[channelIndex] = std::current_exception();
+                outcomes[channelIndex] = Threw;
+            }
+#endif
+            if (outcomes[channelIndex] != Passed) {
+                hasFailed = true;
+            }
+        }
+    };
+    
+    runOnThreads(numThreads, hasFailed, worker);
+    
+    // the first channel that did not pass decides, like in the sequential evaluation
+    for (int channelIndex = 0; channelIndex < numChannels; ++channelIndex) {
+        switch (outcomes[channelIndex]) {
+            case Passed:
+                continue;
+#ifndef SLB_EXCEPTIONS_DISABLED
+            case Threw:
+                std::rethrow_exception(exceptions[channelIndex]);
+#endif
+            default:
+                return false; // failed (channels are only skipped after a failure)
+        }
+    }
+    return true;
+}
+} // namespace Execution
+
+} // namespace AudioTraits
+} // namespace slb
@@ -0,0 +1,95 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+#include <algorithm>
+#include <initializer_list>
+#include <vector>
+
+#include "Utils.hpp"
+
+namespace slb {
+namespace AudioTraits {
+
+/** A contiguous range of FFT bins: first..last (inclusive) */
+struct BinRange
+{
+    int first;
+    int last;
+
+    int size() const { return last - first + 1; }
+    bool contains(int bin) const { return bin >= first && bin <= last; }
+    bool operator==(const BinRange& other) const { return first == other.first && last == other.last; }
+    bool operator!=(const BinRange& other) const { return !(*this == other); }
+};
+
+/**
+ * A set of FFT bins, stored as a sorted list of disjoint, non-adjacent ranges. Frequency selections consist of a few
+ * bands, so this is much more compact than a list of the individual bins, and a scan over all bins can step through
+ * the ranges alongside the bins instead of looking up every bin.
+ */
+class BinMask
+{
+public:
+    BinMask() = default;
+    BinMask(std::initializer_list<BinRange> ranges)
+    {
+        for (const auto& range : ranges) {
+            add(range);
+        }
+    }
+
+    /** Adds the bins of the range to the mask -- merges it with the ranges it overlaps or touches */
+    void add(const BinRange& range)
+    {
+        SLB_ASSERT(range.first >= 0 && range.last >= range.first, "invalid bin range");
+        // first range that ends at or after the bin before the new one: the new range is inserted or merged there
+        auto begin = std::lower_bound(m_ranges.begin(), m_ranges.end(), range.first - 1,
+                                      [](const BinRange& r, int bin) { return r.last < bin; });
+        auto end = begin;
+        BinRange merged = range;
+        while (end != m_ranges.end() && end->first <= range.last + 1) {
+            merged.first = std::min(merged.first, end->first);
+            merged.last = std::max(merged.last, end->last);
+            ++end;
+        }
+        auto position = m_ranges.erase(begin, end);
+        m_ranges.insert(position, merged);
+    }
+
+    bool contains(int bin) const
+    {
+        auto range = std::lower_bound(m_ranges.begin(), m_ranges.end(), bin, [](const BinRange& r, int b) { return r.last < b; });
+        return range != m_ranges.end() && range->contains(bin);
+    }
+
+    bool isEmpty() const { return m_ranges.empty(); }
+
+    /** @returns the number of bins in the mask */
+    int getNumBins() const
+    {
+        int numBins = 0;
+        for (const auto& range : m_ranges) {
+            numBins += range.size();
+        }
+        return numBins;
+    }
+
+    /** @returns the ranges in ascending order */
+    const std::vector<BinRange>& getRanges() const { return m_ranges; }
+
+    bool operator==(const BinMask& other) const { return m_ranges == other.m_ranges; }
+    bool operator!=(const BinMask& other) const { return !(*this == other); }
+
+private:
+    std::vector<BinRange> m_ranges;
+};
+
+} // namespace AudioTraits
+} // namespace slb
@@ -0,0 +1,248 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+#include "SignalAdapters.hpp"
+#include "FrequencyDomain/Helpers.hpp"
+#include "FrequencyDomain/RealValuedFFT.hpp"
+
+namespace slb {
+namespace AudioTraits {
+namespace FrequencyDomainHelpers
+{
+
+/**
+ * Calculates the cross-correlation of a signal and a reference for a range of lags:
+ *
+ *      r[lag] = sum_n( signal[n + lag] * reference[n] )        for minLag <= lag < minLag + numLags
+ *
+ * A positive lag means the signal lags the reference. The calculation is done with FFTs, block by block along the
+ * reference, so its cost is O(n log n) in the signal length and the lag range is only limited by the maximum FFT length.
+ * The FFT and its work buffers are allocated once, for a fixed number of lags, and reused for every calculation.
+ */
+class CrossCorrelator
+{
+public:
+    /**
+     * @param numLags number of lags that are calculated
+     * @param maxReferenceSize length of the longest reference that will be passed (only determines the FFT length)
+     */
+    CrossCorrelator(int numLags, int maxReferenceSize) :
+        m_numLags(numLags),
+        m_fft(determineFftLength(numLags, maxReferenceSize)),
+        m_blockSize(m_fft.getLength() - numLags + 1), // guarantees there is no circular wrap-around
+        m_referenceBlock(m_fft.getLength()),
+        m_signalSegment(m_fft.getLength()),
+        m_blockResult(m_fft.getLength()),
+        m_referenceSpectrum(m_fft.getNumBins()),
+        m_signalSpectrum(m_fft.getNumBins())
+    {
+    }
+    
+    int getNumLags() const { return m_numLags; }
+    
+    /** Adds r[minLag] ... r[minLag + numLags - 1] to result, which has to hold numLags values */
+    void accumulate(const ChannelView& signal, const ChannelView& reference, int minLag, float* result)
+    {
+        const int fftLength = m_fft.getLength();
+        for (int blockStart = 0; blockStart < reference.size(); blockStart += m_blockSize) {
+            const int blockLength = std::min(m_blockSize, reference.size() - blockStart);
+            std::fill(m_referenceBlock.begin(), m_referenceBlock.end(), 0.f);
+            for (int n = 0; n < blockLength; ++n) {
+                m_referenceBlock[n] = reference[blockStart + n];
+            }
+            // signal outside of its range counts as zero
+            for (int m = 0; m < fftLength; ++m) {
+                const int signalIndex = blockStart + minLag + m;
+                m_signalSegment[m] = (signalIndex >= 0 && signalIndex < signal.size()) ? signal[signalIndex] : 0.f;
+            }
+            
+            // circular cross-correlation: IFFT( S * conj(R) )
+            m_fft.performForward(m_referenceBlock.data(), m_referenceSpectrum.data());
+            m_fft.performForward(m_signalSegment.data(), m_signalSpectrum.data());
+            for (int k = 0; k < m_fft.getNumBins(); ++k) {
+                m_signalSpectrum[k] *= std::conj(m_referenceSpectrum[k]);
+            }
+            m_fft.performInverse(m_signalSpectrum.data(), m_blockResult.data());
+            
+            for (int k = 0; k < m_numLags; ++k) {
+                result[k] += m_blockResult[k];
+            }
+        }
+    }
+    
+private:
+    /** every block of the reference is correlated with a signal segment that is longer by the lag range */
+    static int determineFftLength(int numLags, int maxReferenceSize)
+    {
+        constexpr int preferredBlockSize = 4096;
+        SLB_ASSERT(numLags > 0, "invalid lag range");
+        int fftLength = static_cast<int>(Utils::nextPowerOfTwo(static_cast<uint32_t>(numLags + std::min(maxReferenceSize, preferredBlockSize))));
+        fftLength = std::min(std::max(fftLength, minFftLength), maxFftLength);
+        SLB_ASSERT(numLags < fftLength, "lag range too large for the supported FFT lengths");
+        return fftLength;
+    }
+    
+    int m_numLags;
+    RealValuedFFT m_fft;
+    int m_blockSize;
+    std::vector<float> m_referenceBlock;
+    std::vector<float> m_signalSegment;
+    std::vector<float> m_blockResult;
+    std::vector<std::complex<float>> m_referenceSpectrum;
+    std::vector<std::complex<float>> m_signalSpectrum;
+};
+
+/**
+ * Calculates the cross-correlation of a signal and a reference for a range of lags -- see CrossCorrelator
+ * @returns a vector with r[minLag] ... r[maxLag]
+ */
+static inline std::vector<float> calculateCrossCorrelation(const ChannelView& signal, const ChannelView& reference, int minLag, int maxLag)
+{
+    SLB_ASSERT(maxLag >= minLag, "invalid lag range");
+    CrossCorrelator crossCorrelator(maxLag - minLag + 1, reference.size());
+    std::vector<float> result(crossCorrelator.getNumLags(), 0.f);
+    crossCorrelator.accumulate(signal, reference, minLag, result.data());
+    return result;
+}
+
+/** @returns the sum of the squared samples */
+static inline double calculateEnergy(const ChannelView& x)
+{
+    double sum = 0;
+    for (int i = 0; i < x.size(); ++i) {
+        sum += static_cast<double>(x[i]) * x[i];
+    }
+    return sum;
+}
+
+} // namespace FrequencyDomainHelpers
+
+/** Result of a delay estimation */
+struct DelayEstimate
+{
+    int delay_samples;  // positive: the signal lags the reference
+    float correlation;  // normalized cross-correlation at this delay: 1 means identical shape
+};
+
+namespace FrequencyDomainHelpers
+{
+/** Locates the peak of a cross-correlation (starting at minDelay_samples) and normalizes it by the signal energies */
+static inline DelayEstimate makeDelayEstimate(const std::vector<float>& crossCorrelation, int minDelay_samples,
+                                              double signalEnergy, double referenceEnergy)
+{
+    auto peak = std::max_element(crossCorrelation.begin(), crossCorrelation.end());
+    const double normalization = std::sqrt(signalEnergy * referenceEnergy);
+    
+    DelayEstimate estimate;
+    estimate.delay_samples = minDelay_samples + static_cast<int>(std::distance(crossCorrelation.begin(), peak));
+    estimate.correlation = (normalization > 0) ? static_cast<float>(*peak / normalization) : 0.f;
+    return estimate;
+}
+
+/**
+ * Estimates the delay of a signal that is passed in consecutive blocks with respect to a reference that is fully
+ * available. Only a fixed-size chunk of the signal is buffered, the cross-correlation is accumulated chunk by chunk.
+ */
+class StreamingDelayEstimator
+{
+public:
+    StreamingDelayEstimator(const ChannelView& reference, int minDelay_samples, int maxDelay_samples) :
+        m_reference(reference),
+        m_minDelay(minDelay_samples),
+        m_maxDelay(maxDelay_samples),
+        m_chunk(chunkSize),
+        m_crossCorrelation(maxDelay_samples - minDelay_samples + 1, 0.f),
+        // a chunk correlates with at most chunkSize + (number of delays - 1) reference samples
+        m_crossCorrelator(static_cast<int>(m_crossCorrelation.size()),
+                          std::min(reference.size(), chunkSize + static_cast<int>(m_crossCorrelation.size()) - 1)),
+        m_referenceEnergy(calculateEnergy(reference))
+    {
+        SLB_ASSERT(maxDelay_samples >= minDelay_samples, "invalid delay range");
+    }
+    
+    /** Appends the samples to the signal */
+    void process(const ChannelView& samples)
+    {
+        for (int i = 0; i < samples.size(); ++i) {
+            m_chunk[m_numSamplesInChunk++] = samples[i];
+            m_signalEnergy += static_cast<double>(samples[i]) * samples[i];
+            if (m_numSamplesInChunk == chunkSize) {
+                processChunk();
+            }
+        }
+    }
+    
+    /** @returns the delay estimate for all samples passed so far */
+    DelayEstimate getEstimate()
+    {
+        processChunk();
+        return makeDelayEstimate(m_crossCorrelation, m_minDelay, m_signalEnergy, m_referenceEnergy);
+    }
+    
+private:
+    static constexpr int chunkSize = 4096;
+    
+    void processChunk()
+    {
+        // The chunk (at position p) only correlates with reference samples n where p <= n + lag < p + chunk length
+        const std::int64_t chunkPosition = m_position;
+        const std::int64_t firstRefIndex = std::max<std::int64_t>(0, chunkPosition - m_maxDelay);
+        const std::int64_t endRefIndex = std::min<std::int64_t>(m_reference.size(), chunkPosition + m_numSamplesInChunk - m_minDelay);
+        if (m_numSamplesInChunk > 0 && endRefIndex > firstRefIndex) {
+            // lags relative to the reference segment: lag' = lag + firstRefIndex - chunkPosition (within ±maxDelay here)
+            const int lagOffset = static_cast<int>(firstRefIndex - chunkPosition);
+            m_crossCorrelator.accumulate(ChannelView(m_chunk.data(), m_numSamplesInChunk),
+                                         m_reference.subView(static_cast<int>(firstRefIndex), static_cast<int>(endRefIndex - firstRefIndex)),
+                                         m_minDelay + lagOffset, m_crossCorrelation.data());
+        }
+        m_position += m_numSamplesInChunk;
+        m_numSamplesInChunk = 0;
+    }
+    
+    ChannelView m_reference;
+    int m_minDelay;
+    int m_maxDelay;
+    std::vector<float> m_chunk;
+    int m_numSamplesInChunk = 0;
+    std::int64_t m_position = 0; // position of the chunk in the signal (streams can be longer than 2^31 samples)
+    std::vector<float> m_crossCorrelation;
+    CrossCorrelator m_crossCorrelator;
+    double m_signalEnergy = 0;
+    double m_referenceEnergy;
+};
+} // namespace FrequencyDomainHelpers
+
+/**
+ * Estimates the delay of the signal with respect to the reference by locating the peak of their cross-correlation
+ * within the given range of delays.
+ */
+static inline DelayEstimate estimateDelay(const ChannelView& signal, const ChannelView& reference, int minDelay_samples, int maxDelay_samples)
+{
+    std::vector<float> crossCorrelation = FrequencyDomainHelpers::calculateCrossCorrelation(signal, reference, minDelay_samples, maxDelay_samples);
+    return FrequencyDomainHelpers::makeDelayEstimate(crossCorrelation, minDelay_samples,
+                                                     FrequencyDomainHelpers::calculateEnergy(signal),
+                                                     FrequencyDomainHelpers::calculateEnergy(reference));
+}
+
+/** Estimates the delay of the signal with respect to the reference, within ±maxDelay_samples */
+static inline DelayEstimate estimateDelay(const ChannelView& signal, const ChannelView& reference, int maxDelay_samples)
+{
+    SLB_ASSERT(maxDelay_samples >= 0, "invalid delay range");
+    return estimateDelay(signal, reference, -maxDelay_samples, maxDelay_samples);
+}
+
+} // namespace AudioTraits
+} // namespace slb
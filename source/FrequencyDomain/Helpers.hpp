@@ -9,11 +9,18 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
+#include <complex>
 #include <set>
+#include <utility>
 #include <vector>
 
+#include "FrequencyDomain/BinMask.hpp"
 #include "FrequencyDomain/RealValuedFFT.hpp"
+#include "FrequencyDomain/Windows.hpp"
 #include "FrequencySelection.hpp"
+#include "Kernels.hpp"
+#include "SignalAdapters.hpp"
 
 namespace slb {
 namespace AudioTraits {
@@ -21,98 +28,318 @@ namespace AudioTraits {
 namespace FrequencyDomainHelpers
 {
 // MARK: - Constants
-constexpr int fftLength = 4096;
-static_assert(Utils::isPowerOfTwo(fftLength), "FFT has to be power of 2");
-constexpr int numBins = fftLength / 2 + 1;
+constexpr int minFftLength = FFTPlan::minLength; // range supported by RealValuedFFT
+constexpr int maxFftLength = FFTPlan::maxLength;
+constexpr int defaultFftLength = 4096;
+static_assert(Utils::isPowerOfTwo(defaultFftLength), "FFT has to be power of 2");
+
+/** @returns true if the FFT length is a power of 2 in the range supported by RealValuedFFT */
+static inline bool isValidFftLength(int fftLength)
+{
+    return fftLength >= minFftLength && fftLength <= maxFftLength && Utils::isPowerOfTwo(fftLength);
+}
+
+/** @returns the number of bins (DC until Nyquist frequency) produced by an FFT of the given length */
+static inline int getNumBins(int fftLength)
+{
+    return fftLength / 2 + 1;
+}
 
 // MARK: - Helper functions
 template<typename T=float>
 inline void applyHannWindow(std::vector<T>& channelSignal)
 {
-    int i = 0;
-    for (auto& sample : channelSignal) {
-        double window = 0.5 * (1 - std::cos(2*M_PI * i++ / (channelSignal.size()-1)));
-        sample *= static_cast<T>(window);
-    }
+    applyWindow(channelSignal.data(), static_cast<int>(channelSignal.size()), WindowType::Hann);
 }
 
-/** Create list of bins that correspond to one FrequencyRange */
-static inline std::set<int> determineCorrespondingBins(const FreqBand& frequencyRange, float sampleRate)
+/** Determine the range of bins that corresponds to one FrequencyRange */
+static inline BinRange determineCorrespondingBins(const FreqBand& frequencyRange, float sampleRate,
+                                                  int fftLength = defaultFftLength)
 {
-    std::set<int> bins;
+    SLB_ASSERT(isValidFftLength(fftLength), "invalid FFT length");
     
     float freqStart = std::get<0>(frequencyRange.get());
     float freqEnd = std::get<1>(frequencyRange.get());
-    int expectedBinStart = static_cast<int>(std::floor(freqStart / sampleRate * fftLength));
-    int expectedBinEnd = static_cast<int>(std::ceil(freqEnd / sampleRate * fftLength));
+    int expectedBinStart = static_cast<int>(std::floor(freqStart / sampleRate * static_cast<float>(fftLength)));
+    int expectedBinEnd = static_cast<int>(std::ceil(freqEnd / sampleRate * static_cast<float>(fftLength)));
     SLB_ASSERT(expectedBinStart >= 0, "invalid frequency range");
-    SLB_ASSERT(expectedBinEnd < numBins, "frequency range too high for this sampling rate");
+    SLB_ASSERT(expectedBinEnd < getNumBins(fftLength), "frequency range too high for this sampling rate");
     
-    for (int i=expectedBinStart; i <= expectedBinEnd; ++i) {
-        bins.insert(i);
+    return BinRange{expectedBinStart, expectedBinEnd};
+}
+
+/** Create an aggregated mask of the bins that correspond to all in bands in the selection */
+static inline BinMask determineCorrespondingBins(const Freqs& frequencySelection, float sampleRate,
+                                                 int fftLength = defaultFftLength)
+{
+    BinMask bins;
+    for (const auto& frequencyRange : frequencySelection.getRanges()) {
+        bins.add(determineCorrespondingBins(frequencyRange, sampleRate, fftLength));
     }
     return bins;
 }
 
-/** Create an aggregated list of bins that correspond to all in bands in the selection */
-static inline std::set<int> determineCorrespondingBins(const Freqs& frequencySelection, float sampleRate)
+/** Determine the range of bins of every band in the selection (in the order of the selection) */
+static inline std::vector<BinRange> determineBinsPerBand(const Freqs& frequencySelection, float sampleRate,
+                                                         int fftLength = defaultFftLength)
 {
-    std::set<int> bins;
-    
+    std::vector<BinRange> binsPerBand;
     for (const auto& frequencyRange : frequencySelection.getRanges()) {
-        std::set<int> binsForThisRange = determineCorrespondingBins(frequencyRange, sampleRate);
-        bins.insert(binsForThisRange.begin(), binsForThisRange.end());
+        binsPerBand.push_back(determineCorrespondingBins(frequencyRange, sampleRate, fftLength));
     }
-    return bins;
+    return binsPerBand;
 }
 
-/** @returns the absolute values of the bin contents for a given signal, normalized to the highest-valued bin */
-static inline std::vector<float> getNormalizedBinValues(std::vector<float>& channelSignal)
+// MARK: - Bin scans
+
+/**
+ * @returns the highest bin value outside the mask (0 if all bins are part of the mask).
+ * The gaps between the ranges of the mask are scanned in a single pass, without a lookup per bin.
+ */
+static inline float maxOutsideMask(const std::vector<float>& binValues, const BinMask& mask)
 {
-    // TODO: use overlap-add for cleaner results (?)
+    const int numBins = static_cast<int>(binValues.size());
+    float maxValue = 0.f;
+    int gapStart = 0;
+    auto scanGap = [&](int gapEnd) {
+        for (int k = gapStart; k < std::min(gapEnd, numBins); ++k) {
+            maxValue = std::max(maxValue, binValues[k]);
+        }
+    };
+    for (const auto& range : mask.getRanges()) {
+        scanGap(range.first);
+        gapStart = range.last + 1;
+    }
+    scanGap(numBins);
+    return maxValue;
+}
+
+/**
+ * @returns true if every band has at least one bin that reaches the (linear) threshold. The bins of a band are only
+ * scanned until the first one that does, and the scan stops at the first band that has none.
+ */
+static inline bool anyInsideEachBand(const std::vector<float>& binValues, const std::vector<BinRange>& bands, float threshold)
+{
+    for (const auto& band : bands) {
+        SLB_ASSERT(band.last < static_cast<int>(binValues.size()), "band outside of the spectrum");
+        if (!Kernels::containsAbsValueAtLeast(binValues.data() + band.first, band.size(), threshold)) {
+            return false; // no signal in any bin in this band
+        }
+    }
+    return true;
+}
+
+/** The scale of the normalized bin values */
+enum class BinScale
+{
+    Magnitude,  // |X|: compare with Utils::dB2Linear(threshold_dB)
+    Power       // |X|^2 -- skips the square root of every bin: compare with Utils::dB2Power(threshold_dB)
+};
+
+/** @returns the threshold_dB (relative to the highest-valued bin) as a normalized bin value of the given scale */
+static inline float binValueForThreshold(float threshold_dB, BinScale scale = BinScale::Magnitude)
+{
+    return scale == BinScale::Power ? Utils::dB2Power(threshold_dB) : Utils::dB2Linear(threshold_dB);
+}
+
+/** Accumulates the magnitudes or powers of the bins in place: accumulatedBins += |bins| (or |bins|^2) */
+static inline void accumulateBins(const std::complex<float>* bins, std::vector<float>& accumulatedBins, BinScale scale)
+{
+    const int numBins = static_cast<int>(accumulatedBins.size());
+    if (scale == BinScale::Power) {
+        for (int k = 0; k < numBins; ++k) {
+            accumulatedBins[k] += std::norm(bins[k]);
+        }
+    } else {
+        for (int k = 0; k < numBins; ++k) {
+            accumulatedBins[k] += std::abs(bins[k]);
+        }
+    }
+}
+
+/**
+ * Normalizes the bins to the highest-valued bin, which becomes 1 (0dB) -- the DC bin is set to 0.
+ * The bins of a silent spectrum remain 0.
+ */
+static inline void normalizeBins(std::vector<float>& bins)
+{
+    if (bins.empty()) {
+        return;
+    }
+    // normally, we would normalize then bin values with numChunks and fftLength, but here
+    // we choose to define the highest-valued bin as 0dB, therefore we normalize by it
+    float maxBinValue = 0.f;
+    for (float binValue : bins) {
+        maxBinValue = std::max(maxBinValue, binValue);
+    }
+    if (maxBinValue > 0.f) {
+        for (auto& binValue : bins) {
+            binValue /= maxBinValue;
+        }
+    }
+    
+    // Hard-code DC bin to 0
+    bins[0] = 0;
+}
+
+/**
+ * Windows a chunk of up to fftLength samples into the FFT input buffer. A shorter chunk (the tail of a signal) is
+ * zero-padded.
+ */
+static inline void windowChunk(const ChannelView& chunk, const std::vector<float>& window, std::vector<float>& fftInput)
+{
+    const int numSamples = chunk.size();
+    SLB_ASSERT(numSamples <= static_cast<int>(fftInput.size()), "chunk longer than the FFT");
+    if (chunk.isContiguous()) {
+        Kernels::multiply(chunk.data(), window.data(), fftInput.data(), numSamples);
+    } else {
+        for (int i = 0; i < numSamples; ++i) {
+            fftInput[i] = chunk[i];
+        }
+        Kernels::multiply(fftInput.data(), window.data(), numSamples);
+    }
+    std::fill(fftInput.begin() + numSamples, fftInput.end(), 0.f);
+}
+
+/**
+ * @returns the absolute values (or powers) of the bin contents for a given channel, normalized to the highest-valued
+ * bin. The signal is analyzed in chunks of fftLength samples: shorter FFTs are faster, longer ones have a finer
+ * resolution. Every chunk is windowed with the given window type, the last chunk is zero-padded.
+ *
+ * The chunks are read from the channel directly and windowed into the FFT input buffer, the channel is not copied.
+ * @see WelchEstimator for an analysis with overlapping frames
+ */
+static inline std::vector<float> getNormalizedBinValues(const ChannelView& channelSignal, int fftLength = defaultFftLength,
+                                                        WindowType windowType = WindowType::Hann, BinScale scale = BinScale::Magnitude)
+{
+    SLB_ASSERT(isValidFftLength(fftLength), "invalid FFT length");
 
     RealValuedFFT fft(fftLength);
+    const std::vector<float>& window = WindowTables::get(windowType, fftLength);
+    std::vector<float> fftInput(fftLength);
+    std::vector<std::complex<float>> chunkBins(getNumBins(fftLength));
+    
+    // Accumulated over all chunks - init with 0
+    std::vector<float> accumulatedBins(getNumBins(fftLength), 0.f);
     
     // perform FFT in several chunks
-    constexpr int chunkSize = fftLength;
-    float numChunksFract = static_cast<float>(channelSignal.size()) / chunkSize;
-    int numChunks = static_cast<int>(std::ceil(numChunksFract));
-    channelSignal.resize(numChunks * chunkSize); // pad to a multiple of full chunks
+    const int chunkSize = fftLength;
+    for (int chunkStart = 0; chunkStart < channelSignal.size(); chunkStart += chunkSize) {
+        const int numChunkSamples = std::min(chunkSize, channelSignal.size() - chunkStart);
+        windowChunk(channelSignal.subView(chunkStart, numChunkSamples), window, fftInput);
+        fft.performForward(fftInput.data(), chunkBins.data());
+        accumulateBins(chunkBins.data(), accumulatedBins, scale);
+    }
     
-    // Accumulated over all chunks - init with 0
-    std::vector<float> accumulatedBins(numBins, 0.f);
+    normalizeBins(accumulatedBins);
+    return accumulatedBins;
+}
+
+/** @returns the absolute values (or powers) of the bin contents for a given signal, normalized to the highest-valued bin */
+static inline std::vector<float> getNormalizedBinValues(const std::vector<float>& channelSignal, int fftLength = defaultFftLength,
+                                                        WindowType windowType = WindowType::Hann, BinScale scale = BinScale::Magnitude)
+{
+    return getNormalizedBinValues(ChannelView(channelSignal.data(), static_cast<int>(channelSignal.size())), fftLength, windowType, scale);
+}
+
+/**
+ * Incremental version of getNormalizedBinValues(): the samples of a channel are passed in consecutive blocks of any
+ * size, and only one chunk (fftLength samples) is held in memory. The result is identical.
+ */
+class SpectrumAccumulator
+{
+public:
+    explicit SpectrumAccumulator(int fftLength = defaultFftLength, WindowType windowType = WindowType::Hann,
+                                 BinScale scale = BinScale::Magnitude) :
+        m_fft(validateFftLength(fftLength)),
+        m_scale(scale),
+        m_window(WindowTables::get(windowType, fftLength)),
+        m_chunk(fftLength, 0.f),
+        m_chunkBins(getNumBins(fftLength)),
+        m_accumulatedBins(getNumBins(fftLength), 0.f) {}
     
-    for (int chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex) {
-        auto chunkBegin = channelSignal.begin() + chunkIndex * chunkSize;
-        std::vector<float> chunkTimeDomain{chunkBegin, chunkBegin + chunkSize};
-        
-        applyHannWindow(chunkTimeDomain);
-        
-        std::vector<std::complex<float>> freqDomainData = fft.performForward(chunkTimeDomain);
-        std::vector<float> binValuesForChunk;
-        for (const auto& binValue : freqDomainData) {
-            binValuesForChunk.emplace_back(std::abs(binValue));
+    /** Appends the samples to the analysis */
+    void process(const ChannelView& samples)
+    {
+        const int chunkSize = static_cast<int>(m_chunk.size());
+        for (int i = 0; i < samples.size(); ++i) {
+            m_chunk[m_numSamplesInChunk++] = samples[i];
+            if (m_numSamplesInChunk == chunkSize) {
+                processChunk();
+            }
         }
-        
-        // accumulate: accumulatedBins += binValues
-        SLB_ASSERT(binValuesForChunk.size() == accumulatedBins.size());
-        for (int k=0; k < accumulatedBins.size(); ++k) {
-            accumulatedBins[k] += binValuesForChunk[k];
+    }
+    
+    /** @returns the normalized bin values of all samples passed so far -- the last chunk is zero-padded */
+    std::vector<float> getNormalizedBinValues()
+    {
+        if (m_numSamplesInChunk > 0) {
+            std::fill(m_chunk.begin() + m_numSamplesInChunk, m_chunk.end(), 0.f);
+            processChunk();
         }
+        
+        std::vector<float> normalizedBins = m_accumulatedBins;
+        normalizeBins(normalizedBins);
+        return normalizedBins;
     }
     
-    // normally, we would normalize then bin values with numChunks and fftLength, but here
-    // we choose to define the highest-valued bin as 0dB, therefore we normalize by it
-    float maxBinValue = *std::max_element(accumulatedBins.begin(), accumulatedBins.end());
-    for (auto& binValue : accumulatedBins) {
-        binValue /= maxBinValue;
+private:
+    static int validateFftLength(int fftLength)
+    {
+        SLB_ASSERT(isValidFftLength(fftLength), "invalid FFT length");
+        return fftLength;
     }
     
-    // Hard-code DC bin to 0
-    accumulatedBins[0] = 0;
+    void processChunk()
+    {
+        Kernels::multiply(m_chunk.data(), m_window.data(), static_cast<int>(m_chunk.size()));
+        m_fft.performForward(m_chunk.data(), m_chunkBins.data());
+        accumulateBins(m_chunkBins.data(), m_accumulatedBins, m_scale);
+        m_numSamplesInChunk = 0;
+    }
+    
+    RealValuedFFT m_fft;
+    BinScale m_scale;
+    const std::vector<float>& m_window;
+    std::vector<float> m_chunk;
+    int m_numSamplesInChunk = 0;
+    std::vector<std::complex<float>> m_chunkBins;
+    std::vector<float> m_accumulatedBins;
+};
 
-    return accumulatedBins;
-}
+/** Accumulates the spectra of the selected channels of a multichannel signal that is passed in consecutive blocks */
+class ChannelSpectraAccumulator
+{
+public:
+    ChannelSpectraAccumulator(const std::set<int>& selectedChannels, int fftLength)
+    {
+        m_channelSpectra.reserve(selectedChannels.size());
+        for (int chNumber : selectedChannels) {
+            m_channelSpectra.emplace_back(chNumber, SpectrumAccumulator(fftLength));
+        }
+    }
+    
+    void process(const ISignal& block)
+    {
+        for (auto& channelSpectrum : m_channelSpectra) {
+            channelSpectrum.second.process(block.getChannelView(channelSpectrum.first - 1)); // channels are 1-based, indices 0-based
+        }
+    }
+    
+    /** @returns the normalized bin values of every selected channel (in ascending order of channels) */
+    std::vector<std::vector<float>> getNormalizedBinValues()
+    {
+        std::vector<std::vector<float>> result;
+        result.reserve(m_channelSpectra.size());
+        for (auto& channelSpectrum : m_channelSpectra) {
+            result.emplace_back(channelSpectrum.second.getNormalizedBinValues());
+        }
+        return result;
+    }
+    
+private:
+    std::vector<std::pair<int, SpectrumAccumulator>> m_channelSpectra;
+};
 } // namespace FrequencyDomainHelpers
 
 } // namespace AudioTraits
@@ -8,11 +8,16 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <array>
 #include <complex>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
+#include "FrequencyDomain/VectorizedFFT.hpp"
 #include "Utils.hpp"
 
 #ifdef __clang__
@@ -37,95 +42,244 @@ extern "C"
 
 namespace slb {
 
-class RealValuedFFT
+/** The complex FFT kernel used by a RealValuedFFT */
+enum class FFTImplementation
+{
+    Reference,  // TI's mixed radix-4/2 kernel (natural C reference code -- scalar)
+    Vectorized  // radix-4 Stockham kernel (with a final radix-2 stage for odd powers of 2), using the SIMD instructions
+                // selected in Kernels.hpp -- see VectorizedFFT
+};
+
+/** The vectorized kernel is used whenever SIMD instructions are available (see SLB_DISABLE_SIMD) */
+#ifdef SLB_SIMD
+constexpr FFTImplementation defaultFFTImplementation = FFTImplementation::Vectorized;
+#else
+constexpr FFTImplementation defaultFFTImplementation = FFTImplementation::Reference;
+#endif
+
+/**
+ * The immutable setup of a RealValuedFFT of a given length: radix, twiddle and split tables.
+ * Plans are built once per FFT length and shared through a process-wide, thread-safe registry.
+ *
+ * All powers of 2 from minLength to maxLength are supported. The tables are generated for the length at hand, the
+ * reference (TI) kernel however is limited to maxReferenceLength by its fixed bit-reversal table -- longer plans only
+ * contain the tables of the vectorized kernel.
+ */
+class FFTPlan
 {
 public:
-    explicit RealValuedFFT(int fftLength) :
-        m_fftLength(Utils::nextPowerOfTwo(fftLength)),
+    static constexpr int minLength = 16;
+    static constexpr int maxLength = 1 << 20;
+    static constexpr int maxReferenceLength = 16384;
+    
+    /** @returns the shared plan for the given FFT length (next-higher power of 2) -- built on first request only */
+    static std::shared_ptr<const FFTPlan> get(int fftLength)
+    {
+        static std::mutex mutex;
+        static std::map<int, std::shared_ptr<const FFTPlan>> plans;
+        
+        const int length = static_cast<int>(Utils::nextPowerOfTwo(static_cast<uint32_t>(fftLength)));
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = plans.find(length);
+        if (it == plans.end()) {
+            it = plans.emplace(length, std::shared_ptr<const FFTPlan>(new FFTPlan(length))).first;
+        }
+        return it->second;
+    }
+    
+    int getLength() const { return m_fftLength; }
+    int getRadix() const { return m_radix; }
+    bool supportsReferenceImplementation() const { return m_fftLength <= maxReferenceLength; }
+    
+    // The TI routines take non-const pointers, but do not modify the tables
+    float* getSplitTableA() const { return const_cast<float*>(reinterpret_cast<const float*>(m_splitTableA.data())); }
+    float* getSplitTableB() const { return const_cast<float*>(reinterpret_cast<const float*>(m_splitTableB.data())); }
+    float* getTwiddleTable() const { return const_cast<float*>(reinterpret_cast<const float*>(m_twiddleTable.data())); }
+    
+    /** Twiddle factors of the vectorized kernel (N = fftLength/2 points) */
+    const VectorizedFFT::Twiddles& getVectorizedTwiddles() const { return m_vectorizedTwiddles; }
+    
+private:
+    explicit FFTPlan(int fftLength) :
+        m_fftLength(validateLength(fftLength)),
+        m_radix(isPowerOfFour(m_fftLength / 2) ? 4 : 2),
         m_splitTableA(m_fftLength/2),
         m_splitTableB(m_fftLength/2),
-        m_twiddleTable(m_fftLength/2)
+        m_twiddleTable(supportsReferenceImplementation() ? m_fftLength/2 : 0),
+        m_vectorizedTwiddles(m_fftLength/2)
     {
         const int N = m_fftLength / 2;
-     
-        if (N == 16 || N == 64 || N == 256 || N == 1024 || N == 4096) {
-            m_radix = 4; // is power of 4 (exponent even?)
-        } else if (N == 8 || N == 32 || N == 128 || N == 512 || N == 2048 || N == 8192) {
-            m_radix = 2; // is power of 2 and not of 4 (exponent odd?)
-        } else {
-            SLB_ASSERT_ALWAYS("Length not supported");
+        if (supportsReferenceImplementation()) {
+            tw_gen(reinterpret_cast<float*>(&m_twiddleTable[0]), N);
         }
-
-        tw_gen(reinterpret_cast<float*>(&m_twiddleTable[0]), N);
         split_gen(reinterpret_cast<float*>(&m_splitTableA[0]), reinterpret_cast<float*>(&m_splitTableB[0]), N);
     }
     
+    static int validateLength(int fftLength)
+    {
+        SLB_ASSERT(fftLength >= minLength && fftLength <= maxLength && Utils::isPowerOfTwo(static_cast<uint32_t>(fftLength)),
+                   "Length not supported");
+        return fftLength;
+    }
+    
+    /** @returns true for powers of 2 with an even exponent */
+    static bool isPowerOfFour(int n) { return (n & 0x55555555) != 0; }
+    
+    int m_fftLength;
+    int m_radix;
+    
+    std::vector<std::complex<float>> m_splitTableA;
+    std::vector<std::complex<float>> m_splitTableB;
+    std::vector<std::complex<float>> m_twiddleTable;
+    VectorizedFFT::Twiddles m_vectorizedTwiddles;
+};
+
+/**
+ * Real-valued FFT. This is a lightweight executor: the tables are shared via an FFTPlan, only the work buffers are
+ * owned by each instance -- an instance must therefore not be used by several threads at once.
+ *
+ * The complex FFT of half the length is calculated with the given FFTImplementation. Both produce the same results
+ * within floating-point rounding. Lengths beyond FFTPlan::maxReferenceLength always use the vectorized kernel.
+ */
+class RealValuedFFT
+{
+public:
+    explicit RealValuedFFT(int fftLength, FFTImplementation implementation = defaultFFTImplementation) :
+        RealValuedFFT(FFTPlan::get(fftLength), implementation) {}
+    
+    explicit RealValuedFFT(std::shared_ptr<const FFTPlan> plan, FFTImplementation implementation = defaultFFTImplementation) :
+        m_plan(std::move(plan)),
+        m_fftLength(m_plan->getLength()),
+        m_implementation(m_plan->supportsReferenceImplementation() ? implementation : FFTImplementation::Vectorized),
+        m_pseudoComplexBuffer(m_fftLength/2),
+        m_complexBuffer(m_fftLength/2 + 1),
+        m_freqDomainBuffer(m_fftLength + 1),
+        m_splitComplexBuffer(m_implementation == FFTImplementation::Vectorized ? 2 * m_fftLength : 0)
+    {
+    }
+    
+    int getLength() const { return m_fftLength; }
+    int getNumBins() const { return m_fftLength / 2 + 1; }
+    FFTImplementation getImplementation() const { return m_implementation; }
+    
     /** Calculates the FFT for a real-valued input - using a split-complex FFT */
     std::vector<std::complex<float>> performForward(const std::vector<float>& realInput)
     {
         SLB_ASSERT(realInput.size() >= m_fftLength, "Signal length must match FFT Size"); // TODO: zero-padding
         
+        std::vector<std::complex<float>> result(getNumBins());
+        performForward(realInput.data(), result.data());
+        return result;
+    }
+    
+    /**
+     * Calculates the FFT for a real-valued input - using a split-complex FFT.
+     * Does not allocate any memory: all intermediate results are held in pre-allocated member buffers.
+     *
+     * @param realInput must point to fftLength samples
+     * @param complexOutput must point to space for fftLength/2+1 bins (DC until Nyquist frequency)
+     */
+    void performForward(const float* realInput, std::complex<float>* complexOutput)
+    {
         // Trick: We calculate a complex FFT of length N/2  ('split complex FFT')
         const int N = m_fftLength / 2;
         
-        // Split input sequence into a pseudo-complex signal (second half is imag part)
-        std::vector<std::complex<float>> pseudoComplexInput(N);
-        for (int k = 0; k < pseudoComplexInput.size(); ++k) {
-            pseudoComplexInput.at(k) = { realInput.at(2*k+0), realInput.at(2*k+1) };
-        }
+        // Split input sequence into a pseudo-complex signal (second half is imag part): since std::complex<float>
+        // is layout-compatible with float[2], this boils down to a plain copy. (the FFT works in-place on this buffer)
+        std::copy(realInput, realInput + m_fftLength, reinterpret_cast<float*>(m_pseudoComplexBuffer.data()));
         
-        std::vector<std::complex<float>> complexOutput(N+1);
-        const int offset = 0;
-
         // Forward FFT Calculation using a N-point complex FFT
-        DSPF_sp_fftSPxSP(N, reinterpret_cast<float*>(pseudoComplexInput.data()),
-                         reinterpret_cast<float*>(m_twiddleTable.data()),
-                         reinterpret_cast<float*>(complexOutput.data()),
-                         const_cast<unsigned char*>(brev_data),
-                         m_radix, offset, N);
-
-        std::vector<std::complex<float>> freqDomainBuffer(m_fftLength+1); // entire length +1 required for calculation
-        FFT_Split(N, reinterpret_cast<float*>(complexOutput.data()),
-                  reinterpret_cast<float*>(m_splitTableA.data()),
-                  reinterpret_cast<float*>(m_splitTableB.data()),
-                  reinterpret_cast<float*>(freqDomainBuffer.data()));
+        if (m_implementation == FFTImplementation::Vectorized) {
+            performComplexVectorized(m_pseudoComplexBuffer.data(), m_complexBuffer.data(), false, 1.f);
+        } else {
+            const int offset = 0;
+            DSPF_sp_fftSPxSP(N, reinterpret_cast<float*>(m_pseudoComplexBuffer.data()),
+                             m_plan->getTwiddleTable(),
+                             reinterpret_cast<float*>(m_complexBuffer.data()),
+                             const_cast<unsigned char*>(brev_data),
+                             m_plan->getRadix(), offset, N);
+        }
 
-        // TODO: make buffers members so there's no allocation
+        // entire length +1 required for calculation
+        FFT_Split(N, reinterpret_cast<float*>(m_complexBuffer.data()),
+                  m_plan->getSplitTableA(),
+                  m_plan->getSplitTableB(),
+                  reinterpret_cast<float*>(m_freqDomainBuffer.data()));
         
-        return {freqDomainBuffer.begin(), freqDomainBuffer.begin() + N+1}; // only return fftLength/2+1 complex pairs
+        // only return fftLength/2+1 complex pairs
+        std::copy(m_freqDomainBuffer.begin(), m_freqDomainBuffer.begin() + N+1, complexOutput);
     }
     
     std::vector<float> performInverse(const std::vector<std::complex<float>>& complexInput)
     {
-        const int N = m_fftLength / 2;
-        std::vector<std::complex<float>> tempComplexBuffer(complexInput.size());
-        
-        IFFT_Split(N, reinterpret_cast<const float*>(complexInput.data()),
-                   reinterpret_cast<float*>(m_splitTableA.data()),
-                   reinterpret_cast<float*>(m_splitTableB.data()),
-                   reinterpret_cast<float*>(tempComplexBuffer.data()));
+        SLB_ASSERT(complexInput.size() >= getNumBins(), "Input must contain fftLength/2+1 bins");
         
         std::vector<float> timeDomainBuffer(m_fftLength);
-        const int offset = 0;
+        performInverse(complexInput.data(), timeDomainBuffer.data());
+        return timeDomainBuffer;
+    }
+    
+    /**
+     * Calculates the inverse FFT, resulting in a real-valued output.
+     * Does not allocate any memory: all intermediate results are held in pre-allocated member buffers.
+     *
+     * @param complexInput must point to fftLength/2+1 bins (DC until Nyquist frequency)
+     * @param realOutput must point to space for fftLength samples
+     */
+    void performInverse(const std::complex<float>* complexInput, float* realOutput)
+    {
+        const int N = m_fftLength / 2;
         
-        // Inverse FFT Calculation using N/2 complex IFFT
-        DSPF_sp_ifftSPxSP(N, reinterpret_cast<float*>(tempComplexBuffer.data()),
-                          reinterpret_cast<float*>(m_twiddleTable.data()),
-                          reinterpret_cast<float*>(timeDomainBuffer.data()),
-                          const_cast<unsigned char*>(brev_data),
-                          m_radix, offset, N);
+        IFFT_Split(N, reinterpret_cast<const float*>(complexInput),
+                   m_plan->getSplitTableA(),
+                   m_plan->getSplitTableB(),
+                   reinterpret_cast<float*>(m_pseudoComplexBuffer.data()));
         
-        // TODO: make buffers members so there's no allocation
-        return timeDomainBuffer;
+        // Inverse FFT Calculation using N/2 complex IFFT, scaled by 1/N
+        if (m_implementation == FFTImplementation::Vectorized) {
+            performComplexVectorized(m_pseudoComplexBuffer.data(), reinterpret_cast<std::complex<float>*>(realOutput),
+                                     true, 1.f / static_cast<float>(N));
+        } else {
+            // (works in-place on the input buffer)
+            const int offset = 0;
+            DSPF_sp_ifftSPxSP(N, reinterpret_cast<float*>(m_pseudoComplexBuffer.data()),
+                              m_plan->getTwiddleTable(),
+                              realOutput,
+                              const_cast<unsigned char*>(brev_data),
+                              m_plan->getRadix(), offset, N);
+        }
     }
     
+    const std::shared_ptr<const FFTPlan>& getPlan() const { return m_plan; }
+    
 private:
+    /** N-point complex FFT of interleaved data (N = fftLength/2), using the vectorized kernel on split-complex data */
+    void performComplexVectorized(const std::complex<float>* input, std::complex<float>* output, bool isInverse, float scale)
+    {
+        const int N = m_fftLength / 2;
+        float* re = m_splitComplexBuffer.data();
+        float* im = re + N;
+        float* workRe = im + N;
+        float* workIm = workRe + N;
+        for (int i = 0; i < N; ++i) {
+            re[i] = input[i].real();
+            im[i] = input[i].imag();
+        }
+        VectorizedFFT::transform(N, re, im, workRe, workIm, m_plan->getVectorizedTwiddles(), isInverse);
+        for (int i = 0; i < N; ++i) {
+            output[i] = { re[i] * scale, im[i] * scale };
+        }
+    }
+    
+    std::shared_ptr<const FFTPlan> m_plan;
     int m_fftLength;
-    int m_radix;
+    FFTImplementation m_implementation;
     
-    std::vector<std::complex<float>> m_splitTableA;
-    std::vector<std::complex<float>> m_splitTableB;
-    std::vector<std::complex<float>> m_twiddleTable;
+    // Work buffers -- pre-allocated so that transforms do not allocate
+    std::vector<std::complex<float>> m_pseudoComplexBuffer; // N/2 : input of the complex FFT / output of split IFFT
+    std::vector<std::complex<float>> m_complexBuffer;       // N/2+1 : output of the complex FFT
+    std::vector<std::complex<float>> m_freqDomainBuffer;    // N+1 : output of the split (full spectrum)
+    std::vector<float> m_splitComplexBuffer;                // 2N (vectorized only) : real & imag parts, and scratch
 };
 
 } // namespace slb
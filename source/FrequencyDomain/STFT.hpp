@@ -0,0 +1,270 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "FrequencyDomain/Helpers.hpp"
+#include "FrequencyDomain/RealValuedFFT.hpp"
+#include "FrequencyDomain/Windows.hpp"
+#include "Kernels.hpp"
+#include "SignalAdapters.hpp"
+
+namespace slb {
+namespace AudioTraits {
+
+/** A time interval in seconds (inclusive) -- without an end, it lasts until the end of the signal */
+class TimeRange
+{
+public:
+    explicit TimeRange(float start_s, float end_s = std::numeric_limits<float>::max()) : m_start(start_s), m_end(end_s)
+    {
+        SLB_ASSERT(start_s >= 0.f, "invalid start time");
+        SLB_ASSERT(end_s >= start_s, "invalid time range");
+    }
+
+    float getStart() const { return m_start; }
+    float getEnd() const { return m_end; }
+
+private:
+    float m_start;
+    float m_end;
+};
+
+struct STFTSettings
+{
+    int hopSize = 0; // samples between the starts of consecutive frames: (0, fftLength] -- 0: half the FFT length
+    WindowType windowType = WindowType::Hann;
+};
+
+namespace FrequencyDomainHelpers
+{
+/** Shorter than defaultFftLength: a frame of the short-time analysis should only span a short time (~21ms at 48kHz) */
+constexpr int defaultStftLength = 1024;
+}
+
+/**
+ * Short-time Fourier transform: the signal is cut into frames of fftLength samples (every hopSize samples), and the
+ * spectrum of every frame is calculated individually -- unlike getNormalizedBinValues(), which accumulates the spectra
+ * of the entire signal. This shows how the spectral content changes over time.
+ *
+ * The spectrum of a frame is passed to a callback as soon as the frame is complete, normalized to its own highest-valued
+ * bin (a silent frame has all bins at 0), so the same thresholds can be used as for the other frequency-domain traits.
+ * The samples can be passed in consecutive blocks of any size. The FFT plan and all buffers are allocated once, in the
+ * constructor. An incomplete frame at the end is not analyzed.
+ */
+class ShortTimeFourierTransform
+{
+public:
+    explicit ShortTimeFourierTransform(int fftLength = FrequencyDomainHelpers::defaultStftLength,
+                                       const STFTSettings& settings = STFTSettings{}) :
+        m_fft(validateFftLength(fftLength)),
+        m_hopSize(determineHopSize(fftLength, settings)),
+        m_window(WindowTables::get(settings.windowType, fftLength)),
+        m_frame(fftLength, 0.f),
+        m_windowedFrame(fftLength),
+        m_frameBins(FrequencyDomainHelpers::getNumBins(fftLength)),
+        m_frameBinValues(FrequencyDomainHelpers::getNumBins(fftLength)) {}
+
+    /**
+     * Appends the samples to the analysis. For every frame they complete, onFrame(frameIndex, normalizedBinValues) is
+     * called -- it returns false to stop the analysis (the remaining samples are discarded).
+     * @returns false if the analysis was stopped
+     */
+    template<typename FrameCallback>
+    bool process(const ChannelView& samples, FrameCallback&& onFrame)
+    {
+        const int fftLength = getFftLength();
+        int i = 0;
+        while (i < samples.size()) {
+            const int numSamplesToCopy = std::min(fftLength - m_numSamplesInFrame, samples.size() - i);
+            const ChannelView run = samples.subView(i, numSamplesToCopy);
+            if (run.isContiguous()) {
+                std::copy(run.data(), run.data() + numSamplesToCopy, m_frame.begin() + m_numSamplesInFrame);
+            } else {
+                for (int j = 0; j < numSamplesToCopy; ++j) {
+                    m_frame[m_numSamplesInFrame + j] = run[j];
+                }
+            }
+            m_numSamplesInFrame += numSamplesToCopy;
+            i += numSamplesToCopy;
+
+            if (m_numSamplesInFrame == fftLength) {
+                analyzeFrame();
+                const bool shouldContinue = onFrame(m_numFrames++, static_cast<const std::vector<float>&>(m_frameBinValues));
+                // keep the overlapping part for the next frame
+                std::copy(m_frame.begin() + m_hopSize, m_frame.end(), m_frame.begin());
+                m_numSamplesInFrame = fftLength - m_hopSize;
+                if (!shouldContinue) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    int getFftLength() const { return static_cast<int>(m_frame.size()); }
+    int getHopSize() const { return m_hopSize; }
+    std::int64_t getNumFrames() const { return m_numFrames; }
+
+    /** @returns the index of the first and last frame (inclusive) whose center lies in the time range */
+    std::pair<std::int64_t, std::int64_t> getFramesInTimeRange(const TimeRange& timeRange, float sampleRate) const
+    {
+        return getFramesInTimeRange(timeRange, sampleRate, getFftLength(), m_hopSize);
+    }
+
+    /** @returns the index of the first and last frame (inclusive) whose center lies in the time range -- without an instance */
+    static std::pair<std::int64_t, std::int64_t> getFramesInTimeRange(const TimeRange& timeRange, float sampleRate, int fftLength, int hopSize)
+    {
+        SLB_ASSERT(sampleRate > 0.f, "invalid sample rate");
+        SLB_ASSERT(hopSize > 0 && hopSize <= fftLength, "invalid hop size");
+        // frame k spans [k * hopSize, k * hopSize + fftLength), its center is at k * hopSize + fftLength/2
+        const double halfFrame = fftLength / 2.0;
+        const double firstFrame = std::ceil((static_cast<double>(timeRange.getStart()) * sampleRate - halfFrame) / hopSize);
+        const double lastFrame = std::floor((static_cast<double>(timeRange.getEnd()) * sampleRate - halfFrame) / hopSize);
+        return { toFrameIndex(std::max(firstFrame, 0.0), fftLength, hopSize), toFrameIndex(std::max(lastFrame, -1.0), fftLength, hopSize) };
+    }
+
+    /** @returns the hop size the settings result in for the given FFT length (resolves the default) */
+    static int determineHopSize(int fftLength, const STFTSettings& settings)
+    {
+        SLB_ASSERT(settings.hopSize >= 0 && settings.hopSize <= fftLength, "Hop size has to be in (0, fftLength] -- or 0 for the default");
+        return settings.hopSize == 0 ? fftLength / 2 : settings.hopSize;
+    }
+
+private:
+    static int validateFftLength(int fftLength)
+    {
+        SLB_ASSERT(FrequencyDomainHelpers::isValidFftLength(fftLength), "invalid FFT length");
+        return fftLength;
+    }
+
+    /**
+     * Converts a frame position to a frame index. Positions beyond the last frame whose sample indices fit into 64 bits
+     * (an open-ended time range) are mapped to that frame -- millions of years of audio, so the analysis never ends early.
+     */
+    static std::int64_t toFrameIndex(double frame, int fftLength, int hopSize)
+    {
+        const std::int64_t maxFrame = (std::numeric_limits<std::int64_t>::max() - fftLength) / hopSize;
+        // compare in double, but return the exact limit: it may not be representable as a double
+        return frame >= static_cast<double>(maxFrame) ? maxFrame : static_cast<std::int64_t>(frame);
+    }
+
+    void analyzeFrame()
+    {
+        Kernels::multiply(m_frame.data(), m_window.data(), m_windowedFrame.data(), getFftLength());
+        m_fft.performForward(m_windowedFrame.data(), m_frameBins.data());
+
+        for (int k = 0; k < static_cast<int>(m_frameBinValues.size()); ++k) {
+            m_frameBinValues[k] = std::abs(m_frameBins[k]);
+        }
+        FrequencyDomainHelpers::normalizeBins(m_frameBinValues);
+    }
+
+    RealValuedFFT m_fft;
+    int m_hopSize;
+    const std::vector<float>& m_window;
+    std::vector<float> m_frame;
+    int m_numSamplesInFrame = 0;
+    std::vector<float> m_windowedFrame;
+    std::vector<std::complex<float>> m_frameBins;
+    std::vector<float> m_frameBinValues;
+    std::int64_t m_numFrames = 0;
+};
+
+namespace FrequencyDomainHelpers
+{
+/** @returns the normalized bin values of every frame of the channel -- see ShortTimeFourierTransform */
+static inline std::vector<std::vector<float>> getSpectrogram(const ChannelView& channelSignal, int fftLength = defaultStftLength,
+                                                             const STFTSettings& settings = STFTSettings{})
+{
+    std::vector<std::vector<float>> frames;
+    ShortTimeFourierTransform stft(fftLength, settings);
+    stft.process(channelSignal, [&frames](std::int64_t /*frameIndex*/, const std::vector<float>& normalizedBinValues)
+    {
+        frames.push_back(normalizedBinValues);
+        return true;
+    });
+    return frames;
+}
+
+/**
+ * Analyzes the frames of the selected channels that lie in a time range (see ShortTimeFourierTransform), for signals
+ * that are passed in consecutive blocks. Samples outside of the time range are skipped without analysis.
+ */
+class TimeRangeAnalysis
+{
+public:
+    TimeRangeAnalysis(const std::set<int>& selectedChannels, const TimeRange& timeRange, float sampleRate, int fftLength,
+                      const STFTSettings& settings = STFTSettings{})
+    {
+        m_channelAnalyses.reserve(selectedChannels.size());
+        for (int chNumber : selectedChannels) {
+            m_channelAnalyses.emplace_back(chNumber, ShortTimeFourierTransform(fftLength, settings));
+        }
+        const int hopSize = ShortTimeFourierTransform::determineHopSize(fftLength, settings);
+        const std::pair<std::int64_t, std::int64_t> frames = ShortTimeFourierTransform::getFramesInTimeRange(timeRange, sampleRate, fftLength, hopSize);
+        m_firstSample = frames.first * hopSize;
+        m_endSample = std::max(m_firstSample, frames.second * hopSize + fftLength);
+    }
+
+    /**
+     * Analyzes the frames of the block that lie in the time range: frameCheck(normalizedBinValues) is called for every
+     * frame of every selected channel, and returns false to stop the analysis.
+     * @returns false if the analysis was stopped
+     */
+    template<typename FrameCheck>
+    bool process(const ISignal& block, FrameCheck&& frameCheck)
+    {
+        const std::int64_t blockStart = m_position;
+        m_position += block.getNumSamples();
+        // part of the block within the time range
+        const int numSamples = block.getNumSamples();
+        const int begin = static_cast<int>(std::min<std::int64_t>(std::max<std::int64_t>(0, m_firstSample - blockStart), numSamples));
+        const int end = static_cast<int>(std::max<std::int64_t>(std::min<std::int64_t>(numSamples, m_endSample - blockStart), 0));
+        if (begin >= end) {
+            return true;
+        }
+        for (auto& channelAnalysis : m_channelAnalyses) {
+            // channels are 1-based, indices 0-based
+            const ChannelView samples = block.getChannelView(channelAnalysis.first - 1).subView(begin, end - begin);
+            const bool shouldContinue = channelAnalysis.second.process(samples, [&frameCheck](std::int64_t /*frameIndex*/, const std::vector<float>& normalizedBinValues)
+            {
+                return frameCheck(normalizedBinValues);
+            });
+            if (!shouldContinue) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** @returns true once all samples of the time range have been processed */
+    bool isComplete() const { return m_position >= m_endSample; }
+
+    /** @returns the number of frames analyzed per channel */
+    std::int64_t getNumFrames() const { return m_channelAnalyses.empty() ? 0 : m_channelAnalyses.front().second.getNumFrames(); }
+
+private:
+    std::vector<std::pair<int, ShortTimeFourierTransform>> m_channelAnalyses;
+    std::int64_t m_firstSample; // first sample of the first frame in the time range
+    std::int64_t m_endSample; // one past the last sample of the last frame in the time range
+    std::int64_t m_position = 0; // index of the next sample to be processed
+};
+} // namespace FrequencyDomainHelpers
+
+} // namespace AudioTraits
+} // namespace slb
@@ -0,0 +1,147 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "SignalAdapters.hpp"
+#include "FrequencyDomain/Helpers.hpp"
+#include "FrequencyDomain/Welch.hpp"
+
+namespace slb {
+namespace AudioTraits {
+
+/**
+ * Stores the normalized bin values of analyzed channels, so that each channel's spectrum is only calculated once.
+ *
+ * Entries are keyed on the channel's data (identity), its length and the FFT configuration. The cache assumes the
+ * underlying audio data does not change while it is in use -- call clear() if it does.
+ * Entries can be requested from several threads at once (e.g. when checking with exec::parallel).
+ *
+ * By default, the spectra are calculated from non-overlapping chunks (see FrequencyDomainHelpers::getNormalizedBinValues).
+ * A cache constructed with WelchSettings estimates them with Welch's method instead (see WelchEstimator).
+ */
+class SpectrumCache
+{
+public:
+    SpectrumCache() = default;
+    explicit SpectrumCache(const WelchSettings& welchSettings) : m_useWelch(true), m_welchSettings(welchSettings) {}
+
+    /**
+     * @returns the normalized bin values of the given channelIndex (0-based) -- calculated on first access only.
+     * Each FFT length is a separate entry.
+     */
+    const std::vector<float>& getNormalizedBinValues(const ISignal& signal, int channelIndex,
+                                                     int fftLength = FrequencyDomainHelpers::defaultFftLength)
+    {
+        SLB_ASSERT(channelIndex >= 0 && channelIndex < signal.getNumChannels(), "invalid channel index");
+
+        const Key key = makeKey(signal, channelIndex, fftLength);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(key);
+            if (it != m_entries.end()) {
+                return it->second;
+            }
+        }
+        // The analysis runs unlocked, so different channels can be analyzed concurrently. If another thread was
+        // faster with the same entry, its result is kept (entries never change once inserted).
+        std::vector<float> binValues = m_useWelch
+            ? FrequencyDomainHelpers::getWelchNormalizedBinValues(signal.getChannelView(channelIndex), fftLength, m_welchSettings)
+            : FrequencyDomainHelpers::getNormalizedBinValues(signal.getChannelView(channelIndex), fftLength);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.emplace(key, std::move(binValues)).first->second;
+    }
+
+    int getNumEntries() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<int>(m_entries.size());
+    }
+    
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+    }
+
+private:
+    /** (signal identity, stride, channelIndex, numSamples, fftLength) */
+    using Key = std::tuple<const void*, int, int, int, int>;
+
+    static Key makeKey(const ISignal& signal, int channelIndex, int fftLength)
+    {
+        // Use the address of the channel data, so different adapters around the same data share entries -- the stride
+        // tells apart views that start at the same address, e.g. the first channel of a planar and an interleaved buffer
+        const ChannelView channelView = signal.getChannelView(channelIndex);
+        return Key{channelView.data(), channelView.getStride(), channelIndex, signal.getNumSamples(), fftLength};
+    }
+
+    bool m_useWelch = false;
+    WelchSettings m_welchSettings;
+    std::map<Key, std::vector<float>> m_entries;
+    mutable std::mutex m_mutex;
+};
+
+/**
+ * Wraps around an existing signal and caches the results of its spectral analysis. Passing an AnalyzedSignal to
+ * several frequency-domain checks means every channel's spectrum is only calculated once.
+ * With WelchSettings, the frequency-domain checks use Welch spectra (overlapping, averaged frames) of this signal.
+ *
+ * @note This object holds a reference to the wrapped signal, which must not be modified while it is in use.
+ */
+class AnalyzedSignal : public ISignal
+{
+public:
+    explicit AnalyzedSignal(const ISignal& signal) : m_signal(signal) {}
+    AnalyzedSignal(const ISignal& signal, const WelchSettings& welchSettings) : m_signal(signal), m_spectrumCache(welchSettings) {}
+    explicit AnalyzedSignal(const ISignal&& signal) = delete; // do not wrap temporaries
+    AnalyzedSignal(const ISignal&& signal, const WelchSettings& welchSettings) = delete;
+
+    int getNumChannels() const override { return m_signal.getNumChannels(); }
+    int getNumSamples()  const override { return m_signal.getNumSamples(); }
+    const float* const* getData() const override { return m_signal.getData(); }
+    std::vector<float> getChannelDataCopy(int channelIndex) const override { return m_signal.getChannelDataCopy(channelIndex); }
+    ChannelView getChannelView(int channelIndex) const override { return m_signal.getChannelView(channelIndex); }
+
+    /** @returns the cached normalized bin values of the given channelIndex (0-based) */
+    const std::vector<float>& getNormalizedBinValues(int channelIndex, int fftLength = FrequencyDomainHelpers::defaultFftLength) const
+    {
+        return m_spectrumCache.getNormalizedBinValues(m_signal, channelIndex, fftLength);
+    }
+
+    const SpectrumCache& getSpectrumCache() const { return m_spectrumCache; }
+
+private:
+    const ISignal& m_signal;
+    mutable SpectrumCache m_spectrumCache;
+};
+
+namespace FrequencyDomainHelpers
+{
+/**
+ * @returns the normalized bin values of the given channelIndex (0-based). If the signal is an AnalyzedSignal, these
+ * are served from its cache, otherwise they are calculated into the supplied storage.
+ */
+static inline const std::vector<float>& getNormalizedBinValues(const ISignal& signal, int channelIndex, std::vector<float>& storage,
+                                                               int fftLength = defaultFftLength)
+{
+    if (const auto* analyzedSignal = dynamic_cast<const AnalyzedSignal*>(&signal)) {
+        return analyzedSignal->getNormalizedBinValues(channelIndex, fftLength);
+    }
+    storage = getNormalizedBinValues(signal.getChannelView(channelIndex), fftLength);
+    return storage;
+}
+} // namespace FrequencyDomainHelpers
+
+} // namespace AudioTraits
+} // namespace slb
@@ -0,0 +1,255 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "Kernels.hpp"
+
+namespace slb {
+
+/**
+ * Complex FFT kernel operating on split-complex data (separate arrays for the real and imaginary parts).
+ *
+ * It is a radix-4 Stockham FFT (with a final radix-2 stage for odd powers of 2): every stage reads from one buffer and
+ * writes to the other in natural order, so no bit-reversal is needed. The butterflies of a stage are applied to
+ * contiguous runs of 'stride' elements that share their twiddle factors -- on split-complex data, these map directly
+ * onto the SIMD instructions selected in Kernels.hpp. The first stage (stride 1) is vectorized across butterflies
+ * instead, with interleaving stores.
+ */
+namespace VectorizedFFT
+{
+
+/** The twiddle factors of an n-point transform */
+struct Twiddles
+{
+    explicit Twiddles(int n) : re(3 * n / 4), im(3 * n / 4), firstStage(6 * (n / 4))
+    {
+        const double pi = std::acos(-1.0);
+        for (int k = 0; k < 3 * n / 4; ++k) {
+            re[k] = static_cast<float>(std::cos(2 * pi * k / n));
+            im[k] = static_cast<float>(std::sin(2 * pi * k / n));
+        }
+        const int quarterLength = n / 4;
+        for (int p = 0; p < quarterLength; ++p) {
+            for (int j = 0; j < 3; ++j) {
+                firstStage[(2 * j) * quarterLength + p] = re[(j + 1) * p];
+                firstStage[(2 * j + 1) * quarterLength + p] = im[(j + 1) * p];
+            }
+        }
+    }
+
+    std::vector<float> re; // cos(2*pi*k/n), k in [0, 3n/4)
+    std::vector<float> im; // sin(2*pi*k/n), k in [0, 3n/4)
+    std::vector<float> firstStage; // w1..w3 of the first stage's butterflies, in blocks of n/4: w1.re, w1.im, w2.re, ...
+};
+
+namespace Detail
+{
+static inline float add(float a, float b) { return a + b; }
+static inline float sub(float a, float b) { return a - b; }
+static inline float mul(float a, float b) { return a * b; }
+#ifdef SLB_SIMD
+namespace SIMD = AudioTraits::Kernels::SIMD;
+using SIMD::add;
+using SIMD::sub;
+using SIMD::mul;
+#endif
+
+/** A complex value */
+struct ScalarComplex
+{
+    float re;
+    float im;
+};
+
+#ifdef SLB_SIMD
+/** SIMD::width complex values */
+struct VectorComplex
+{
+    SIMD::Vec re;
+    SIMD::Vec im;
+};
+#endif
+
+template<typename C>
+static inline C complexAdd(C a, C b) { return { add(a.re, b.re), add(a.im, b.im) }; }
+
+template<typename C>
+static inline C complexSub(C a, C b) { return { sub(a.re, b.re), sub(a.im, b.im) }; }
+
+template<typename C>
+static inline C complexMul(C a, C b)
+{
+    return { sub(mul(a.re, b.re), mul(a.im, b.im)), add(mul(a.re, b.im), mul(a.im, b.re)) };
+}
+
+/**
+ * Radix-4 butterfly with the twiddle factors w[0..2]:
+ *     y0 = (a + c) + (b + d)          y1 = ((a - c) + rot(b - d)) * w[0]
+ *     y2 = ((a + c) - (b + d)) * w[1] y3 = ((a - c) - rot(b - d)) * w[2]
+ * where rot() multiplies by -i (forward, imagSign = -1) or +i (inverse, imagSign = 1)
+ */
+template<typename C, typename T>
+static inline void radix4(C a, C b, C c, C d, const C (&w)[3], T imagSign, C (&y)[4])
+{
+    const C sumAc = complexAdd(a, c);
+    const C diffAc = complexSub(a, c);
+    const C sumBd = complexAdd(b, d);
+    const C rotBd { mul(imagSign, sub(d.im, b.im)), mul(imagSign, sub(b.re, d.re)) };
+    y[0] = complexAdd(sumAc, sumBd);
+    y[1] = complexMul(complexAdd(diffAc, rotBd), w[0]);
+    y[2] = complexMul(complexSub(sumAc, sumBd), w[1]);
+    y[3] = complexMul(complexSub(diffAc, rotBd), w[2]);
+}
+
+/** Split-complex pointers to the n elements of a buffer */
+struct Buffer
+{
+    float* re;
+    float* im;
+};
+
+/**
+ * A radix-4 stage with the given stride: for every butterfly group p, applies 'stride' butterflies to consecutive
+ * elements. All butterflies of a group share their twiddle factors.
+ */
+static inline void radix4Stage(int n, int stride, Buffer x, Buffer y, const Twiddles& twiddles, float imagSign)
+{
+    const int quarterLength = n / (4 * stride);
+    const int step = n / 4; // distance between the inputs of a butterfly
+    for (int p = 0; p < quarterLength; ++p) {
+        const int k = stride * p; // twiddle index
+        const ScalarComplex w[3] = { { twiddles.re[k], imagSign * twiddles.im[k] },
+                                     { twiddles.re[2 * k], imagSign * twiddles.im[2 * k] },
+                                     { twiddles.re[3 * k], imagSign * twiddles.im[3 * k] } };
+        const float* inRe = x.re + k;
+        const float* inIm = x.im + k;
+        float* outRe = y.re + 4 * k;
+        float* outIm = y.im + 4 * k;
+        int i = 0;
+#ifdef SLB_SIMD
+        const VectorComplex wv[3] = { { SIMD::broadcast(w[0].re), SIMD::broadcast(w[0].im) },
+                                      { SIMD::broadcast(w[1].re), SIMD::broadcast(w[1].im) },
+                                      { SIMD::broadcast(w[2].re), SIMD::broadcast(w[2].im) } };
+        const SIMD::Vec sign = SIMD::broadcast(imagSign);
+        for (; i + SIMD::width <= stride; i += SIMD::width) {
+            VectorComplex out[4];
+            radix4<VectorComplex>({ SIMD::load(inRe + i), SIMD::load(inIm + i) },
+                                  { SIMD::load(inRe + i + step), SIMD::load(inIm + i + step) },
+                                  { SIMD::load(inRe + i + 2 * step), SIMD::load(inIm + i + 2 * step) },
+                                  { SIMD::load(inRe + i + 3 * step), SIMD::load(inIm + i + 3 * step) }, wv, sign, out);
+            for (int j = 0; j < 4; ++j) {
+                SIMD::store(outRe + j * stride + i, out[j].re);
+                SIMD::store(outIm + j * stride + i, out[j].im);
+            }
+        }
+#endif
+        for (; i < stride; ++i) {
+            ScalarComplex out[4];
+            radix4<ScalarComplex>({ inRe[i], inIm[i] }, { inRe[i + step], inIm[i + step] },
+                                  { inRe[i + 2 * step], inIm[i + 2 * step] }, { inRe[i + 3 * step], inIm[i + 3 * step] }, w, imagSign, out);
+            for (int j = 0; j < 4; ++j) {
+                outRe[j * stride + i] = out[j].re;
+                outIm[j * stride + i] = out[j].im;
+            }
+        }
+    }
+}
+
+#ifdef SLB_SIMD
+/** The first radix-4 stage (stride 1), vectorized across SIMD::width butterfly groups */
+static inline void firstRadix4Stage(int n, Buffer x, Buffer y, const Twiddles& twiddles, float imagSign)
+{
+    const int step = n / 4;
+    const float* w = twiddles.firstStage.data();
+    const SIMD::Vec sign = SIMD::broadcast(imagSign);
+    for (int p = 0; p < step; p += SIMD::width) {
+        const VectorComplex wv[3] = { { SIMD::load(w + p), SIMD::mul(sign, SIMD::load(w + step + p)) },
+                                      { SIMD::load(w + 2 * step + p), SIMD::mul(sign, SIMD::load(w + 3 * step + p)) },
+                                      { SIMD::load(w + 4 * step + p), SIMD::mul(sign, SIMD::load(w + 5 * step + p)) } };
+        VectorComplex out[4];
+        radix4<VectorComplex>({ SIMD::load(x.re + p), SIMD::load(x.im + p) },
+                              { SIMD::load(x.re + p + step), SIMD::load(x.im + p + step) },
+                              { SIMD::load(x.re + p + 2 * step), SIMD::load(x.im + p + 2 * step) },
+                              { SIMD::load(x.re + p + 3 * step), SIMD::load(x.im + p + 3 * step) }, wv, sign, out);
+        // the outputs of butterfly group p are the consecutive elements 4p...4p+3
+        SIMD::storeInterleaved4(y.re + 4 * p, out[0].re, out[1].re, out[2].re, out[3].re);
+        SIMD::storeInterleaved4(y.im + 4 * p, out[0].im, out[1].im, out[2].im, out[3].im);
+    }
+}
+#endif
+
+/** The final radix-2 stage of odd powers of 2 (all twiddle factors are 1) */
+static inline void finalRadix2Stage(int n, Buffer x, Buffer y)
+{
+    const int halfLength = n / 2;
+    int i = 0;
+#ifdef SLB_SIMD
+    for (; i + SIMD::width <= halfLength; i += SIMD::width) {
+        const SIMD::Vec aRe = SIMD::load(x.re + i), aIm = SIMD::load(x.im + i);
+        const SIMD::Vec bRe = SIMD::load(x.re + halfLength + i), bIm = SIMD::load(x.im + halfLength + i);
+        SIMD::store(y.re + i, SIMD::add(aRe, bRe));
+        SIMD::store(y.im + i, SIMD::add(aIm, bIm));
+        SIMD::store(y.re + halfLength + i, SIMD::sub(aRe, bRe));
+        SIMD::store(y.im + halfLength + i, SIMD::sub(aIm, bIm));
+    }
+#endif
+    for (; i < halfLength; ++i) {
+        const float aRe = x.re[i], aIm = x.im[i];
+        const float bRe = x.re[halfLength + i], bIm = x.im[halfLength + i];
+        y.re[i] = aRe + bRe;
+        y.im[i] = aIm + bIm;
+        y.re[halfLength + i] = aRe - bRe;
+        y.im[halfLength + i] = aIm - bIm;
+    }
+}
+} // namespace Detail
+
+/**
+ * Calculates the (unscaled) FFT of length n in place.
+ *
+ * @param n power of 2, at least 4
+ * @param re, im n values each: the input, overwritten with the result (both in natural order)
+ * @param workRe, workIm scratch space for n values each
+ * @param twiddles the twiddle factors for length n
+ * @param isInverse calculates the inverse transform (the result is not scaled by 1/n)
+ */
+static inline void transform(int n, float* re, float* im, float* workRe, float* workIm, const Twiddles& twiddles, bool isInverse)
+{
+    const float imagSign = isInverse ? 1.f : -1.f;
+    Detail::Buffer x { re, im };
+    Detail::Buffer y { workRe, workIm };
+    int stride = 1;
+#ifdef SLB_SIMD
+    if (n / 4 >= Detail::SIMD::width) {
+        Detail::firstRadix4Stage(n, x, y, twiddles, imagSign);
+        std::swap(x, y);
+        stride = 4;
+    }
+#endif
+    for (; 4 * stride <= n; stride *= 4) {
+        Detail::radix4Stage(n, stride, x, y, twiddles, imagSign);
+        std::swap(x, y);
+    }
+    if (stride < n) {
+        Detail::finalRadix2Stage(n, x, y);
+        std::swap(x, y);
+    }
+    if (x.re != re) {
+        std::copy(x.re, x.re + n, re);
+        std::copy(x.im, x.im + n, im);
+    }
+}
+} // namespace VectorizedFFT
+
+} // namespace slb
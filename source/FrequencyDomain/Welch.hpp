@@ -0,0 +1,201 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "FrequencyDomain/Helpers.hpp"
+#include "FrequencyDomain/RealValuedFFT.hpp"
+#include "FrequencyDomain/Windows.hpp"
+#include "Kernels.hpp"
+#include "SignalAdapters.hpp"
+
+namespace slb {
+namespace AudioTraits {
+
+/** How the power spectra of the individual frames are combined */
+enum class Averaging
+{
+    Mean,       // classic Welch estimate: lowest variance
+    Median,     // robust against transients in a few frames
+    MaxHold     // the highest power every bin reached in any frame
+};
+
+struct WelchSettings
+{
+    float overlap = 0.5f; // fraction of a frame shared with the next frame: [0, 1)
+    Averaging averaging = Averaging::Mean;
+    WindowType windowType = WindowType::Hann;
+};
+
+/**
+ * Estimates the power spectrum of a signal with Welch's method: the signal is cut into overlapping frames of fftLength
+ * samples, every frame is windowed and transformed, and the power spectra of all frames are averaged.
+ *
+ * Overlapping frames use the samples that are attenuated by the window of one frame in the next one, so a given signal
+ * length yields more frames and a more stable estimate than non-overlapping chunks.
+ *
+ * The samples can be passed in consecutive blocks of any size. The FFT plan and all buffers are allocated once, in the
+ * constructor -- except for median averaging, which has to keep the power spectra of all frames.
+ * An incomplete frame at the end is discarded, unless the signal is shorter than one frame (then it is zero-padded).
+ */
+class WelchEstimator
+{
+public:
+    explicit WelchEstimator(int fftLength = FrequencyDomainHelpers::defaultFftLength, const WelchSettings& settings = WelchSettings{}) :
+        m_fft(validateFftLength(fftLength)),
+        m_settings(settings),
+        m_hopSize(calculateHopSize(fftLength, settings.overlap)),
+        m_window(WindowTables::get(settings.windowType, fftLength)),
+        m_frame(fftLength, 0.f),
+        m_windowedFrame(fftLength),
+        m_frameBins(FrequencyDomainHelpers::getNumBins(fftLength)),
+        m_power(FrequencyDomainHelpers::getNumBins(fftLength), 0.f) {}
+
+    /** Appends the samples to the analysis */
+    void process(const ChannelView& samples)
+    {
+        const int fftLength = static_cast<int>(m_frame.size());
+        for (int i = 0; i < samples.size(); ++i) {
+            m_frame[m_numSamplesInFrame++] = samples[i];
+            if (m_numSamplesInFrame == fftLength) {
+                processFrame();
+                // keep the overlapping part for the next frame
+                std::copy(m_frame.begin() + m_hopSize, m_frame.end(), m_frame.begin());
+                m_numSamplesInFrame = fftLength - m_hopSize;
+            }
+        }
+    }
+
+    /** @returns the averaged power (|X|^2) of every bin of all samples passed so far -- unscaled */
+    std::vector<float> getPowerSpectrum()
+    {
+        if (m_numFrames == 0 && m_numSamplesInFrame > 0) {
+            // shorter than one frame: zero-pad
+            std::fill(m_frame.begin() + m_numSamplesInFrame, m_frame.end(), 0.f);
+            processFrame();
+            m_numSamplesInFrame = 0;
+        }
+        if (m_numFrames == 0) {
+            return m_power;
+        }
+
+        switch (m_settings.averaging) {
+            case Averaging::Mean: {
+                std::vector<float> result = m_power;
+                for (auto& binPower : result) {
+                    binPower /= static_cast<float>(m_numFrames);
+                }
+                return result;
+            }
+            case Averaging::Median: {
+                const int numBins = static_cast<int>(m_power.size());
+                std::vector<float> result(numBins);
+                std::vector<float> binPowers(m_numFrames);
+                for (int k = 0; k < numBins; ++k) {
+                    for (int frame = 0; frame < m_numFrames; ++frame) {
+                        binPowers[frame] = m_framePowers[frame * numBins + k];
+                    }
+                    auto middle = binPowers.begin() + m_numFrames / 2;
+                    std::nth_element(binPowers.begin(), middle, binPowers.end());
+                    result[k] = *middle;
+                    if (m_numFrames % 2 == 0) {
+                        // even number of frames: mean of the two middle values
+                        result[k] = 0.5f * (result[k] + *std::max_element(binPowers.begin(), middle));
+                    }
+                }
+                return result;
+            }
+            case Averaging::MaxHold:
+            default:
+                return m_power;
+        }
+    }
+
+    /**
+     * @returns the magnitudes of all bins, normalized to the highest-valued bin (DC is set to 0) -- the same scale as
+     * FrequencyDomainHelpers::getNormalizedBinValues(), so the result can be used with the same thresholds.
+     * The bins of a silent (or empty) signal remain 0.
+     */
+    std::vector<float> getNormalizedBinValues()
+    {
+        std::vector<float> normalizedBins = getPowerSpectrum();
+        for (auto& binValue : normalizedBins) {
+            binValue = std::sqrt(binValue);
+        }
+        FrequencyDomainHelpers::normalizeBins(normalizedBins);
+        return normalizedBins;
+    }
+
+    int getNumFrames() const { return m_numFrames; }
+    int getHopSize() const { return m_hopSize; }
+
+private:
+    static int validateFftLength(int fftLength)
+    {
+        SLB_ASSERT(FrequencyDomainHelpers::isValidFftLength(fftLength), "invalid FFT length");
+        return fftLength;
+    }
+
+    static int calculateHopSize(int fftLength, float overlap)
+    {
+        SLB_ASSERT(overlap >= 0.f && overlap < 1.f, "Overlap has to be in [0, 1)");
+        return std::max(1, static_cast<int>(std::lround(static_cast<float>(fftLength) * (1.f - overlap))));
+    }
+
+    void processFrame()
+    {
+        std::copy(m_frame.begin(), m_frame.end(), m_windowedFrame.begin());
+        Kernels::multiply(m_windowedFrame.data(), m_window.data(), static_cast<int>(m_windowedFrame.size()));
+        m_fft.performForward(m_windowedFrame.data(), m_frameBins.data());
+
+        const int numBins = static_cast<int>(m_power.size());
+        const bool isMaxHold = (m_settings.averaging == Averaging::MaxHold);
+        for (int k = 0; k < numBins; ++k) {
+            const float binPower = std::norm(m_frameBins[k]);
+            m_power[k] = isMaxHold ? std::max(m_power[k], binPower) : m_power[k] + binPower;
+        }
+        if (m_settings.averaging == Averaging::Median) {
+            for (int k = 0; k < numBins; ++k) {
+                m_framePowers.push_back(std::norm(m_frameBins[k]));
+            }
+        }
+        ++m_numFrames;
+    }
+
+    RealValuedFFT m_fft;
+    WelchSettings m_settings;
+    int m_hopSize;
+    const std::vector<float>& m_window;
+    std::vector<float> m_frame;
+    int m_numSamplesInFrame = 0;
+    std::vector<float> m_windowedFrame;
+    std::vector<std::complex<float>> m_frameBins;
+    std::vector<float> m_power;         // sum (mean) or maximum (max-hold) of the frames' power
+    std::vector<float> m_framePowers;   // power of every frame (median only)
+    int m_numFrames = 0;
+};
+
+namespace FrequencyDomainHelpers
+{
+/** @returns the normalized bin values of the channel, estimated with Welch's method -- see WelchEstimator */
+static inline std::vector<float> getWelchNormalizedBinValues(const ChannelView& channelSignal, int fftLength = defaultFftLength,
+                                                             const WelchSettings& settings = WelchSettings{})
+{
+    WelchEstimator estimator(fftLength, settings);
+    estimator.process(channelSignal);
+    return estimator.getNormalizedBinValues();
+}
+} // namespace FrequencyDomainHelpers
+
+} // namespace AudioTraits
+} // namespace slb
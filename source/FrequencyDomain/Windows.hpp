@@ -0,0 +1,128 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//  
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Utils.hpp"
+
+namespace slb {
+namespace AudioTraits {
+
+enum class WindowType
+{
+    Hann,
+    Hamming,
+    BlackmanHarris, // 4-term, -92dB side lobes
+    FlatTop         // 5-term, for accurate amplitudes
+};
+
+/** Coefficients of a generalized cosine window: w[n] = a0 - a1*cos(x) + a2*cos(2x) - a3*cos(3x) + a4*cos(4x) */
+using WindowCoefficients = std::array<double, 5>;
+
+/** @returns the cosine coefficients of the given window type */
+static inline WindowCoefficients getWindowCoefficients(WindowType type)
+{
+    WindowCoefficients coefficients {};
+    switch (type) {
+        case WindowType::Hann:           coefficients = {{ 0.5, 0.5 }}; break;
+        case WindowType::Hamming:        coefficients = {{ 0.54, 0.46 }}; break;
+        case WindowType::BlackmanHarris: coefficients = {{ 0.35875, 0.48829, 0.14128, 0.01168 }}; break;
+        case WindowType::FlatTop:        coefficients = {{ 0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368 }}; break;
+    }
+    return coefficients;
+}
+
+/** @returns the value of the (symmetric) window with the given coefficients at the given index -- length has to be > 1 */
+static inline double evaluateWindow(const WindowCoefficients& coefficients, int index, int length)
+{
+    const double x = 2*M_PI * index / (length - 1);
+    double value = 0;
+    for (int k = 0; k < static_cast<int>(coefficients.size()) && coefficients[k] != 0; ++k) {
+        const double sign = (k % 2 == 0) ? 1.0 : -1.0;
+        value += sign * coefficients[k] * std::cos(k * x);
+    }
+    return value;
+}
+
+/** @returns the value of the (symmetric) window of the given type and length at the given index */
+static inline double calculateWindowValue(WindowType type, int index, int length)
+{
+    SLB_ASSERT(length > 0 && index >= 0 && index < length, "invalid window index");
+    if (length == 1) {
+        return 1.0;
+    }
+    return evaluateWindow(getWindowCoefficients(type), index, length);
+}
+
+/**
+ * Provides (symmetric) window tables. Every table is calculated once per type and length, and then shared by all
+ * users for the lifetime of the program. Access is thread-safe.
+ * @note Tables are never released: only request them for the (few) FFT lengths in use -- for arbitrary lengths, see
+ * applyWindow().
+ */
+class WindowTables
+{
+public:
+    /** @returns the window table of the given type and length -- the reference stays valid */
+    static const std::vector<float>& get(WindowType type, int length)
+    {
+        SLB_ASSERT(length > 0, "invalid window length");
+        
+        static std::mutex mutex;
+        static std::map<std::pair<WindowType, int>, std::vector<float>> tables;
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto key = std::make_pair(type, length);
+        auto it = tables.find(key);
+        if (it == tables.end()) {
+            it = tables.emplace(key, calculate(type, length)).first;
+        }
+        return it->second;
+    }
+    
+    /** @returns a newly calculated window of the given type and length */
+    static std::vector<float> calculate(WindowType type, int length)
+    {
+        SLB_ASSERT(length > 0, "invalid window length");
+        
+        std::vector<float> window(length, 1.f);
+        if (length > 1) {
+            const WindowCoefficients coefficients = getWindowCoefficients(type);
+            for (int i = 0; i < length; ++i) {
+                window[i] = static_cast<float>(evaluateWindow(coefficients, i, length));
+            }
+        }
+        return window;
+    }
+};
+
+/**
+ * Applies a window of the given type to the samples (in place). The window is calculated on the fly in double
+ * precision, so this works for any length without growing the WindowTables.
+ */
+template<typename T>
+static inline void applyWindow(T* samples, int numSamples, WindowType type = WindowType::Hann)
+{
+    if (numSamples <= 1) {
+        return; // a window of length 1 is 1
+    }
+    const WindowCoefficients coefficients = getWindowCoefficients(type);
+    for (int i = 0; i < numSamples; ++i) {
+        samples[i] *= static_cast<T>(evaluateWindow(coefficients, i, numSamples));
+    }
+}
+
+} // namespace AudioTraits
+} // namespace slb
@@ -0,0 +1,346 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "SignalAdapters.hpp"
+#include "Utils.hpp"
+
+// MARK: - SIMD instruction set selection (compile-time)
+// Define SLB_DISABLE_SIMD to force the scalar implementations.
+#if !defined(SLB_DISABLE_SIMD)
+    #if defined(__AVX__)
+        #include <immintrin.h>
+        #define SLB_SIMD_AVX
+    #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #include <emmintrin.h>
+        #define SLB_SIMD_SSE2
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+        #include <arm_neon.h>
+        #define SLB_SIMD_NEON
+    #endif
+#endif
+
+#if defined(SLB_SIMD_AVX) || defined(SLB_SIMD_SSE2) || defined(SLB_SIMD_NEON)
+    #define SLB_SIMD
+#endif
+
+namespace slb {
+namespace AudioTraits {
+namespace Kernels
+{
+
+#ifdef SLB_SIMD
+/** Thin abstraction over the vector instructions of the selected instruction set */
+namespace SIMD
+{
+#if defined(SLB_SIMD_AVX)
+    using Vec = __m256;
+    constexpr int width = 8;
+    static inline Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    static inline Vec broadcast(float value) { return _mm256_set1_ps(value); }
+    static inline Vec abs(Vec v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), v); }
+    static inline Vec max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+    static inline Vec min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    static inline Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    static inline bool anyGreaterOrEqual(Vec a, Vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ)) != 0; }
+    /** Lane-wise a <= b -- false for NaN lanes */
+    using Mask = __m256;
+    static inline Mask lessOrEqual(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static inline Mask logicalAnd(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+    static inline bool allTrue(Mask mask) { return _mm256_movemask_ps(mask) == 0xFF; }
+    /** Stores a[0] b[0] c[0] d[0] a[1] b[1] ... (4 * width values) */
+    static inline void storeInterleaved4(float* p, Vec a, Vec b, Vec c, Vec d)
+    {
+        const Vec ab0 = _mm256_unpacklo_ps(a, b), ab1 = _mm256_unpackhi_ps(a, b);
+        const Vec cd0 = _mm256_unpacklo_ps(c, d), cd1 = _mm256_unpackhi_ps(c, d);
+        const Vec abcd0 = _mm256_shuffle_ps(ab0, cd0, _MM_SHUFFLE(1, 0, 1, 0)), abcd1 = _mm256_shuffle_ps(ab0, cd0, _MM_SHUFFLE(3, 2, 3, 2));
+        const Vec abcd2 = _mm256_shuffle_ps(ab1, cd1, _MM_SHUFFLE(1, 0, 1, 0)), abcd3 = _mm256_shuffle_ps(ab1, cd1, _MM_SHUFFLE(3, 2, 3, 2));
+        _mm256_storeu_ps(p,      _mm256_permute2f128_ps(abcd0, abcd1, 0x20));
+        _mm256_storeu_ps(p + 8,  _mm256_permute2f128_ps(abcd2, abcd3, 0x20));
+        _mm256_storeu_ps(p + 16, _mm256_permute2f128_ps(abcd0, abcd1, 0x31));
+        _mm256_storeu_ps(p + 24, _mm256_permute2f128_ps(abcd2, abcd3, 0x31));
+    }
+#elif defined(SLB_SIMD_SSE2)
+    using Vec = __m128;
+    constexpr int width = 4;
+    static inline Vec load(const float* p) { return _mm_loadu_ps(p); }
+    static inline void store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+    static inline Vec broadcast(float value) { return _mm_set1_ps(value); }
+    static inline Vec abs(Vec v) { return _mm_andnot_ps(_mm_set1_ps(-0.f), v); }
+    static inline Vec max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+    static inline Vec min(Vec a, Vec b) { return _mm_min_ps(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+    static inline Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+    static inline bool anyGreaterOrEqual(Vec a, Vec b) { return _mm_movemask_ps(_mm_cmpge_ps(a, b)) != 0; }
+    /** Lane-wise a <= b -- false for NaN lanes */
+    using Mask = __m128;
+    static inline Mask lessOrEqual(Vec a, Vec b) { return _mm_cmple_ps(a, b); }
+    static inline Mask logicalAnd(Mask a, Mask b) { return _mm_and_ps(a, b); }
+    static inline bool allTrue(Mask mask) { return _mm_movemask_ps(mask) == 0xF; }
+    /** Stores a[0] b[0] c[0] d[0] a[1] b[1] ... (4 * width values) */
+    static inline void storeInterleaved4(float* p, Vec a, Vec b, Vec c, Vec d)
+    {
+        const Vec ab0 = _mm_unpacklo_ps(a, b), ab1 = _mm_unpackhi_ps(a, b);
+        const Vec cd0 = _mm_unpacklo_ps(c, d), cd1 = _mm_unpackhi_ps(c, d);
+        _mm_storeu_ps(p,      _mm_movelh_ps(ab0, cd0));
+        _mm_storeu_ps(p + 4,  _mm_movehl_ps(cd0, ab0));
+        _mm_storeu_ps(p + 8,  _mm_movelh_ps(ab1, cd1));
+        _mm_storeu_ps(p + 12, _mm_movehl_ps(cd1, ab1));
+    }
+#elif defined(SLB_SIMD_NEON)
+    using Vec = float32x4_t;
+    constexpr int width = 4;
+    static inline Vec load(const float* p) { return vld1q_f32(p); }
+    static inline void store(float* p, Vec v) { vst1q_f32(p, v); }
+    static inline Vec broadcast(float value) { return vdupq_n_f32(value); }
+    static inline Vec abs(Vec v) { return vabsq_f32(v); }
+    static inline Vec max(Vec a, Vec b) { return vmaxq_f32(a, b); }
+    static inline Vec min(Vec a, Vec b) { return vminq_f32(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return vmulq_f32(a, b); }
+    static inline Vec add(Vec a, Vec b) { return vaddq_f32(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return vsubq_f32(a, b); }
+    static inline bool anyTrue(uint32x4_t mask)
+    {
+        uint32x2_t reduced = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+        return (vget_lane_u32(reduced, 0) | vget_lane_u32(reduced, 1)) != 0;
+    }
+    static inline bool anyGreaterOrEqual(Vec a, Vec b) { return anyTrue(vcgeq_f32(a, b)); }
+    /** Lane-wise a <= b -- false for NaN lanes */
+    using Mask = uint32x4_t;
+    static inline Mask lessOrEqual(Vec a, Vec b) { return vcleq_f32(a, b); }
+    static inline Mask logicalAnd(Mask a, Mask b) { return vandq_u32(a, b); }
+    static inline bool allTrue(Mask mask)
+    {
+        uint32x2_t reduced = vand_u32(vget_low_u32(mask), vget_high_u32(mask));
+        return (vget_lane_u32(reduced, 0) & vget_lane_u32(reduced, 1)) == 0xFFFFFFFFu;
+    }
+    /** Stores a[0] b[0] c[0] d[0] a[1] b[1] ... (4 * width values) */
+    static inline void storeInterleaved4(float* p, Vec a, Vec b, Vec c, Vec d)
+    {
+        float32x4x4_t interleaved { { a, b, c, d } };
+        vst4q_f32(p, interleaved);
+    }
+#endif
+} // namespace SIMD
+#endif // SLB_SIMD
+
+// MARK: - Scalar implementations (reference & fallback for strided data)
+namespace Scalar
+{
+/** @returns true if at least one sample's absolute value reaches the threshold. Exits as soon as one is found. */
+static inline bool containsAbsValueAtLeast(const float* samples, int numSamples, int stride, float threshold)
+{
+    for (int i = 0; i < numSamples; ++i) {
+        if (std::abs(samples[Utils::stridedOffset(i, stride)]) >= threshold) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @returns true if the magnitudes of the sample pair differ at most by the given (linear) ratio, i.e.
+ * max(|a|, |b|) <= maxRatio * min(|a|, |b|) -- written as two ordered comparisons, so a NaN never matches.
+ * (std::max and std::min would silently drop a NaN operand.)
+ */
+static inline bool isMagnitudeWithinRatio(float absA, float absB, float maxRatio)
+{
+    return (absA <= maxRatio * absB) & (absB <= maxRatio * absA);
+}
+
+/**
+ * @returns true if the magnitudes of all sample pairs differ at most by the given (linear) ratio, i.e.
+ * max(|a|, |b|) <= maxRatio * min(|a|, |b|). Exits at the first pair that does not. NaN samples never match.
+ */
+static inline bool areMagnitudesWithinRatio(const float* a, int strideA, const float* b, int strideB, int numSamples, float maxRatio)
+{
+    for (int i = 0; i < numSamples; ++i) {
+        const float absA = std::abs(a[Utils::stridedOffset(i, strideA)]);
+        const float absB = std::abs(b[Utils::stridedOffset(i, strideB)]);
+        if (!isMagnitudeWithinRatio(absA, absB, maxRatio)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Multiplies the samples element-wise with the factors into the result (which may be the samples themselves) */
+static inline void multiply(const float* samples, const float* factors, float* result, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i) {
+        result[i] = samples[i] * factors[i];
+    }
+}
+
+/** Multiplies the samples element-wise with the factors (in place) */
+static inline void multiply(float* samples, const float* factors, int numSamples)
+{
+    multiply(samples, factors, samples, numSamples);
+}
+} // namespace Scalar
+
+// MARK: - Strided implementations (e.g. interleaved data)
+namespace Strided
+{
+/** Samples per block: the inner loops are branch-free reductions, the result is checked once per block */
+constexpr int blockSize = 64;
+
+/** @returns true if at least one sample's absolute value reaches the threshold. Exits after the block where one is found. */
+static inline bool containsAbsValueAtLeast(const float* samples, int numSamples, int stride, float threshold)
+{
+    int i = 0;
+    for (; i + blockSize <= numSamples; i += blockSize) {
+        const float* block = samples + Utils::stridedOffset(i, stride);
+        float absMax = 0.f;
+        for (int j = 0; j < blockSize; ++j) {
+            absMax = std::max(absMax, std::abs(block[Utils::stridedOffset(j, stride)]));
+        }
+        if (absMax >= threshold) {
+            return true;
+        }
+    }
+    // remainder
+    return Scalar::containsAbsValueAtLeast(samples + Utils::stridedOffset(i, stride), numSamples - i, stride, threshold);
+}
+
+/**
+ * @returns true if the magnitudes of all sample pairs differ at most by the given (linear) ratio, i.e.
+ * max(|a|, |b|) <= maxRatio * min(|a|, |b|). Exits after the block with the first pair that does not. NaN samples
+ * never match.
+ */
+static inline bool areMagnitudesWithinRatio(const float* a, int strideA, const float* b, int strideB, int numSamples, float maxRatio)
+{
+    int i = 0;
+    for (; i + blockSize <= numSamples; i += blockSize) {
+        const float* blockA = a + Utils::stridedOffset(i, strideA);
+        const float* blockB = b + Utils::stridedOffset(i, strideB);
+        bool allWithinRatio = true;
+        for (int j = 0; j < blockSize; ++j) {
+            const float absA = std::abs(blockA[Utils::stridedOffset(j, strideA)]);
+            const float absB = std::abs(blockB[Utils::stridedOffset(j, strideB)]);
+            allWithinRatio &= Scalar::isMagnitudeWithinRatio(absA, absB, maxRatio);
+        }
+        if (!allWithinRatio) {
+            return false;
+        }
+    }
+    // remainder
+    return Scalar::areMagnitudesWithinRatio(a + Utils::stridedOffset(i, strideA), strideA, b + Utils::stridedOffset(i, strideB), strideB,
+                                             numSamples - i, maxRatio);
+}
+} // namespace Strided
+
+// MARK: - Vectorized implementations (contiguous data)
+
+/** @returns true if at least one sample's absolute value reaches the threshold. Exits as soon as one is found. */
+static inline bool containsAbsValueAtLeast(const float* samples, int numSamples, float threshold)
+{
+    int i = 0;
+#ifdef SLB_SIMD
+    // The absolute maximum is tracked over blocks of several vectors, the threshold is checked once per block.
+    constexpr int blockSize = 8 * SIMD::width;
+    const SIMD::Vec thresholdVec = SIMD::broadcast(threshold);
+    for (; i + blockSize <= numSamples; i += blockSize) {
+        SIMD::Vec absMaxA = SIMD::abs(SIMD::load(samples + i));
+        SIMD::Vec absMaxB = SIMD::abs(SIMD::load(samples + i + SIMD::width));
+        for (int j = 2 * SIMD::width; j < blockSize; j += 2 * SIMD::width) {
+            absMaxA = SIMD::max(absMaxA, SIMD::abs(SIMD::load(samples + i + j)));
+            absMaxB = SIMD::max(absMaxB, SIMD::abs(SIMD::load(samples + i + j + SIMD::width)));
+        }
+        if (SIMD::anyGreaterOrEqual(SIMD::max(absMaxA, absMaxB), thresholdVec)) {
+            return true;
+        }
+    }
+#endif
+    // remainder
+    return Scalar::containsAbsValueAtLeast(samples + i, numSamples - i, 1, threshold);
+}
+
+/** @returns true if at least one sample's absolute value reaches the threshold. Exits as soon as one is found. */
+static inline bool containsAbsValueAtLeast(const ChannelView& samples, float threshold)
+{
+    if (samples.isContiguous()) {
+        return containsAbsValueAtLeast(samples.data(), samples.size(), threshold);
+    }
+    return Strided::containsAbsValueAtLeast(samples.data(), samples.size(), samples.getStride(), threshold);
+}
+
+/**
+ * @returns true if the magnitudes of all sample pairs differ at most by the given (linear) ratio, i.e.
+ * max(|a|, |b|) <= maxRatio * min(|a|, |b|). Exits at the first pair that does not. NaN samples never match.
+ */
+static inline bool areMagnitudesWithinRatio(const float* a, const float* b, int numSamples, float maxRatio)
+{
+    int i = 0;
+#ifdef SLB_SIMD
+    // Combine the (ordered, so false for NaN) comparisons |a| <= ratio*|b| and |b| <= ratio*|a| of a block into one
+    // mask, check that all its lanes are true once per block.
+    constexpr int blockSize = 4 * SIMD::width;
+    const SIMD::Vec ratioVec = SIMD::broadcast(maxRatio);
+    for (; i + blockSize <= numSamples; i += blockSize) {
+        const SIMD::Vec firstA = SIMD::abs(SIMD::load(a + i));
+        const SIMD::Vec firstB = SIMD::abs(SIMD::load(b + i));
+        SIMD::Mask withinRatio = SIMD::logicalAnd(SIMD::lessOrEqual(firstA, SIMD::mul(ratioVec, firstB)),
+                                                  SIMD::lessOrEqual(firstB, SIMD::mul(ratioVec, firstA)));
+        for (int j = SIMD::width; j < blockSize; j += SIMD::width) {
+            const SIMD::Vec absA = SIMD::abs(SIMD::load(a + i + j));
+            const SIMD::Vec absB = SIMD::abs(SIMD::load(b + i + j));
+            withinRatio = SIMD::logicalAnd(withinRatio, SIMD::logicalAnd(SIMD::lessOrEqual(absA, SIMD::mul(ratioVec, absB)),
+                                                                         SIMD::lessOrEqual(absB, SIMD::mul(ratioVec, absA))));
+        }
+        if (!SIMD::allTrue(withinRatio)) {
+            return false;
+        }
+    }
+#endif
+    // remainder
+    return Scalar::areMagnitudesWithinRatio(a + i, 1, b + i, 1, numSamples - i, maxRatio);
+}
+
+static inline bool areMagnitudesWithinRatio(const ChannelView& a, const ChannelView& b, float maxRatio)
+{
+    SLB_ASSERT(a.size() == b.size(), "Views must be of equal length for comparison");
+    if (a.isContiguous() && b.isContiguous()) {
+        return areMagnitudesWithinRatio(a.data(), b.data(), a.size(), maxRatio);
+    }
+    return Strided::areMagnitudesWithinRatio(a.data(), a.getStride(), b.data(), b.getStride(), a.size(), maxRatio);
+}
+
+/**
+ * Multiplies the samples element-wise with the factors into the result (which may be the samples themselves), e.g. to
+ * window a chunk of a signal into an FFT buffer
+ */
+static inline void multiply(const float* samples, const float* factors, float* result, int numSamples)
+{
+    int i = 0;
+#ifdef SLB_SIMD
+    for (; i + SIMD::width <= numSamples; i += SIMD::width) {
+        SIMD::store(result + i, SIMD::mul(SIMD::load(samples + i), SIMD::load(factors + i)));
+    }
+#endif
+    // remainder
+    Scalar::multiply(samples + i, factors + i, result + i, numSamples - i);
+}
+
+/** Multiplies the samples element-wise with the factors (in place), e.g. to apply a window */
+static inline void multiply(float* samples, const float* factors, int numSamples)
+{
+    multiply(samples, factors, samples, numSamples);
+}
+
+} // namespace Kernels
+} // namespace AudioTraits
+} // namespace slb
@@ -0,0 +1,266 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+// NOTE: OPTIONAL -- NOT INCLUDED BY AudioTraits.hpp: include this file explicitly to use SignalAdapterMappedWav.
+// It pulls in the platform's memory-mapping API (<windows.h> or the POSIX mmap headers).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "SampleTypes.hpp"
+#include "SignalAdapters.hpp"
+#include "Utils.hpp"
+
+namespace slb {
+namespace AudioTraits {
+
+/** A read-only memory mapping of an entire file -- pages are only loaded when they are accessed */
+class MemoryMappedFile
+{
+public:
+    explicit MemoryMappedFile(const std::string& path)
+    {
+#if defined(_WIN32)
+        m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        SLB_ASSERT(m_file != INVALID_HANDLE_VALUE, "Cannot open file");
+        LARGE_INTEGER fileSize;
+        if (m_file != INVALID_HANDLE_VALUE && GetFileSizeEx(m_file, &fileSize) && fileSize.QuadPart > 0) {
+            m_size = static_cast<std::size_t>(fileSize.QuadPart);
+            m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (m_mapping != nullptr) {
+                m_data = static_cast<const std::uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+        }
+#else
+        m_file = ::open(path.c_str(), O_RDONLY);
+        SLB_ASSERT(m_file >= 0, "Cannot open file");
+        struct stat fileStatus;
+        if (m_file >= 0 && ::fstat(m_file, &fileStatus) == 0 && fileStatus.st_size > 0) {
+            m_size = static_cast<std::size_t>(fileStatus.st_size);
+            void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_file, 0);
+            if (mapping != MAP_FAILED) {
+                m_data = static_cast<const std::uint8_t*>(mapping);
+            }
+        }
+#endif
+        if (m_data == nullptr) {
+            release(); // the assertion throws: the destructor would not run
+        }
+        SLB_ASSERT(m_data != nullptr, "Cannot map file");
+    }
+
+    ~MemoryMappedFile() { release(); }
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    /** @returns the first byte of the file, or nullptr if it could not be mapped */
+    const std::uint8_t* data() const { return m_data; }
+    std::size_t size() const { return m_data != nullptr ? m_size : 0; }
+
+private:
+    /** Unmaps the file and closes all handles */
+    void release()
+    {
+#if defined(_WIN32)
+        if (m_data != nullptr) { UnmapViewOfFile(m_data); }
+        if (m_mapping != nullptr) { CloseHandle(m_mapping); }
+        if (m_file != INVALID_HANDLE_VALUE) { CloseHandle(m_file); }
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_data != nullptr) { ::munmap(const_cast<std::uint8_t*>(m_data), m_size); }
+        if (m_file >= 0) { ::close(m_file); }
+        m_file = -1;
+#endif
+        m_data = nullptr;
+    }
+
+#if defined(_WIN32)
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#else
+    int m_file = -1;
+#endif
+    const std::uint8_t* m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+/**
+ * Adapts a WAV file to the Signal Interface without loading it: the file is memory-mapped, so opening even very long
+ * files is instantaneous and only the parts that are analyzed are read from disk.
+ *
+ * - 32-bit float files are accessed in place: every channel is a strided view onto the interleaved samples.
+ * - 16/24/32-bit integer (PCM) files are converted to float channel by channel, the first time a channel is accessed.
+ *
+ * @note getData() is only available for single-channel float files, otherwise it returns nullptr -- traits access the
+ * samples through getChannelView(). The samples are assumed to be little-endian, as is the host.
+ */
+class SignalAdapterMappedWav : public ISignal
+{
+public:
+    explicit SignalAdapterMappedWav(const std::string& path) : m_file(path)
+    {
+        parseHeader();
+        m_convertedChannels.resize(m_numChannels);
+        if (m_isInPlace && m_numChannels == 1) {
+            m_channelPointer = reinterpret_cast<const float*>(m_samples);
+        }
+    }
+
+    SignalAdapterMappedWav(const SignalAdapterMappedWav&) = delete;
+    SignalAdapterMappedWav& operator=(const SignalAdapterMappedWav&) = delete;
+
+    int getNumChannels() const override { return m_numChannels; }
+    int getNumSamples()  const override { return m_numSamples; }
+    const float* const* getData() const override { return m_channelPointer != nullptr ? &m_channelPointer : nullptr; }
+    std::vector<float> getChannelDataCopy(int channelIndex) const override { return getChannelView(channelIndex).copy(); }
+    ChannelView getChannelView(int channelIndex) const override
+    {
+        SLB_ASSERT(channelIndex >= 0 && channelIndex < getNumChannels(), "invalid channel index");
+        if (m_isInPlace) {
+            return { reinterpret_cast<const float*>(m_samples) + channelIndex, m_numSamples, m_numChannels };
+        }
+        const std::vector<float>& converted = getConvertedChannel(channelIndex);
+        return { converted.data(), m_numSamples };
+    }
+
+    float getSampleRate() const { return static_cast<float>(m_sampleRate); }
+    int getBitsPerSample() const { return m_bitsPerSample; }
+    bool isFloatingPoint() const { return m_isFloatingPoint; }
+
+private:
+    static constexpr std::uint16_t formatPcm = 0x0001;
+    static constexpr std::uint16_t formatIeeeFloat = 0x0003;
+    static constexpr std::uint16_t formatExtensible = 0xFFFE;
+
+    template<typename T>
+    static T read(const std::uint8_t* bytes)
+    {
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+
+    void parseHeader()
+    {
+        const std::uint8_t* data = m_file.data();
+        const std::size_t size = m_file.size();
+        SLB_ASSERT(size >= 12 && std::memcmp(data, "RIFF", 4) == 0 && std::memcmp(data + 8, "WAVE", 4) == 0, "Not a WAV file");
+        if (size < 12) {
+            return;
+        }
+
+        bool hasFormat = false;
+        for (std::size_t chunkStart = 12; chunkStart + 8 <= size; ) {
+            const std::uint8_t* chunk = data + chunkStart;
+            const std::size_t chunkSize = read<std::uint32_t>(chunk + 4);
+            const std::size_t available = std::min(chunkSize, size - chunkStart - 8); // tolerate truncated files
+
+            if (std::memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+                std::uint16_t formatTag = read<std::uint16_t>(chunk + 8);
+                m_numChannels = read<std::uint16_t>(chunk + 10);
+                m_sampleRate = read<std::uint32_t>(chunk + 12);
+                m_bitsPerSample = read<std::uint16_t>(chunk + 22);
+                if (formatTag == formatExtensible && available >= 26) {
+                    formatTag = read<std::uint16_t>(chunk + 32); // first two bytes of the sub-format GUID
+                }
+                m_isFloatingPoint = (formatTag == formatIeeeFloat);
+                const bool isSupportedFormat = (formatTag == formatPcm || formatTag == formatIeeeFloat);
+                const bool isSupportedBitDepth = m_isFloatingPoint ? m_bitsPerSample == 32
+                                                                   : (m_bitsPerSample == 16 || m_bitsPerSample == 24 || m_bitsPerSample == 32);
+                SLB_ASSERT(isSupportedFormat, "Unsupported WAV format");
+                SLB_ASSERT(isSupportedBitDepth, "Unsupported WAV bit depth");
+                SLB_ASSERT(m_numChannels > 0, "Invalid number of channels");
+                hasFormat = isSupportedFormat && isSupportedBitDepth;
+            } else if (std::memcmp(chunk, "data", 4) == 0) {
+                SLB_ASSERT(hasFormat, "WAV format chunk missing");
+                if (!hasFormat || m_numChannels <= 0) {
+                    m_numChannels = 0;
+                    return;
+                }
+                const std::size_t frameSize = static_cast<std::size_t>(m_numChannels) * (m_bitsPerSample / 8);
+                m_samples = chunk + 8;
+                m_numSamples = static_cast<int>(available / frameSize);
+                // in place access needs float alignment -- the mapping itself is page-aligned
+                m_isInPlace = m_isFloatingPoint && (reinterpret_cast<std::uintptr_t>(m_samples) % alignof(float) == 0);
+                return;
+            }
+            chunkStart += 8 + chunkSize + (chunkSize & 1); // chunks are word-aligned
+        }
+        SLB_ASSERT_ALWAYS("WAV data chunk missing");
+        m_numChannels = 0;
+    }
+
+    /** @returns the float samples of the channel -- converted on first access */
+    const std::vector<float>& getConvertedChannel(int channelIndex) const
+    {
+        std::lock_guard<std::mutex> lock(m_conversionMutex);
+        std::unique_ptr<std::vector<float>>& converted = m_convertedChannels[channelIndex];
+        if (converted == nullptr) {
+            converted.reset(new std::vector<float>(m_numSamples));
+            const int bytesPerSample = m_bitsPerSample / 8;
+            const int frameSize = m_numChannels * bytesPerSample;
+            const std::uint8_t* sample = m_samples + channelIndex * bytesPerSample;
+            for (int i = 0; i < m_numSamples; ++i, sample += frameSize) {
+                (*converted)[i] = convertSample(sample);
+            }
+        }
+        return *converted;
+    }
+
+    float convertSample(const std::uint8_t* sample) const
+    {
+        if (m_isFloatingPoint) {
+            return convertUnalignedToFloat<float>(sample);
+        }
+        switch (m_bitsPerSample) {
+            case 16: return convertUnalignedToFloat<std::int16_t>(sample);
+            case 24: return convertUnalignedToFloat<Int24>(sample);
+            default: return convertUnalignedToFloat<std::int32_t>(sample);
+        }
+    }
+
+    MemoryMappedFile m_file;
+    int m_numChannels = 0;
+    int m_numSamples = 0;
+    std::uint32_t m_sampleRate = 0;
+    int m_bitsPerSample = 0;
+    bool m_isFloatingPoint = false;
+    bool m_isInPlace = false;
+    const std::uint8_t* m_samples = nullptr;
+    const float* m_channelPointer = nullptr;
+
+    mutable std::vector<std::unique_ptr<std::vector<float>>> m_convertedChannels;
+    mutable std::mutex m_conversionMutex;
+};
+
+} // namespace AudioTraits
+} // namespace slb
@@ -0,0 +1,98 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "Utils.hpp"
+
+namespace slb {
+namespace AudioTraits {
+
+/** A packed, little-endian 24-bit integer sample (3 bytes, as in 24-bit WAV files or driver buffers) */
+struct Int24
+{
+    std::uint8_t bytes[3];
+};
+static_assert(sizeof(Int24) == 3, "Int24 has to be packed");
+
+/**
+ * Conversion of the supported sample types to float (the type the traits operate on). Integer samples are
+ * normalized to [-1, 1).
+ */
+template<typename T>
+struct SampleConversion;
+
+template<>
+struct SampleConversion<float>
+{
+    static float toFloat(float sample) { return sample; }
+};
+
+template<>
+struct SampleConversion<double>
+{
+    static float toFloat(double sample) { return static_cast<float>(sample); }
+};
+
+template<>
+struct SampleConversion<std::int16_t>
+{
+    static float toFloat(std::int16_t sample) { return static_cast<float>(sample) / 32768.f; }
+};
+
+template<>
+struct SampleConversion<Int24>
+{
+    static float toFloat(Int24 sample)
+    {
+        // sign-extend by placing the 3 bytes in the upper part of a 32-bit integer
+        const std::uint32_t bits = (static_cast<std::uint32_t>(sample.bytes[0]) << 8) | (static_cast<std::uint32_t>(sample.bytes[1]) << 16)
+                                 | (static_cast<std::uint32_t>(sample.bytes[2]) << 24);
+        std::int32_t value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return static_cast<float>(value / 256) / 8388608.f;
+    }
+};
+
+template<>
+struct SampleConversion<std::int32_t>
+{
+    static float toFloat(std::int32_t sample) { return static_cast<float>(static_cast<double>(sample) / 2147483648.0); }
+};
+
+template<typename T, typename = void>
+struct IsSupportedSampleType : std::false_type {};
+
+template<typename T>
+struct IsSupportedSampleType<T, decltype(static_cast<void>(SampleConversion<T>::toFloat(std::declval<T>())))> : std::true_type {};
+
+/** Converts numSamples samples (every stride-th one) to float */
+template<typename T>
+static inline void convertToFloat(const T* samples, int stride, int numSamples, float* destination)
+{
+    for (int i = 0; i < numSamples; ++i) {
+        destination[i] = SampleConversion<T>::toFloat(samples[Utils::stridedOffset(i, stride)]);
+    }
+}
+
+/** @returns the sample at the given (possibly unaligned) address converted to float */
+template<typename T>
+static inline float convertUnalignedToFloat(const void* sample)
+{
+    T value;
+    std::memcpy(&value, sample, sizeof(T));
+    return SampleConversion<T>::toFloat(value);
+}
+
+} // namespace AudioTraits
+} // namespace slb
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "ChannelSelection.hpp"
@@ -18,6 +19,54 @@ namespace AudioTraits {
 
 // MARK: - Infrastructure
 
+/**
+ * Non-owning, read-only view onto the samples of one channel. Consecutive samples are 'stride' elements apart in
+ * memory, which allows viewing interleaved data without copying it.
+ */
+class ChannelView
+{
+public:
+    ChannelView(const float* data, int numSamples, int stride = 1) :
+        m_data(data),
+        m_numSamples(numSamples),
+        m_stride(stride)
+    {
+        SLB_ASSERT(numSamples >= 0, "invalid number of samples");
+        SLB_ASSERT(stride > 0, "invalid stride");
+    }
+    
+    const float& operator[](int sampleIndex) const { return m_data[Utils::stridedOffset(sampleIndex, m_stride)]; }
+    
+    int size() const { return m_numSamples; }
+    int getStride() const { return m_stride; }
+    bool isContiguous() const { return m_stride == 1; }
+    
+    /** @returns a pointer to the first sample */
+    const float* data() const { return m_data; }
+
+    /** @returns a view onto a section of this view, starting at sample 'offset' */
+    ChannelView subView(int offset, int numSamples) const
+    {
+        SLB_ASSERT(offset >= 0 && numSamples >= 0 && offset + numSamples <= m_numSamples, "sub-view out of range");
+        return { m_data + Utils::stridedOffset(offset, m_stride), numSamples, m_stride };
+    }
+    
+    /** @returns a (contiguous) copy of the samples */
+    std::vector<float> copy() const
+    {
+        std::vector<float> result(m_numSamples);
+        for (int i = 0; i < m_numSamples; ++i) {
+            result[i] = (*this)[i];
+        }
+        return result;
+    }
+    
+private:
+    const float* m_data;
+    int m_numSamples;
+    int m_stride;
+};
+
 /**
  * Signal Interface - wraps around an existing signal of arbitrary type.
  *
@@ -30,11 +79,26 @@ public:
     virtual int getNumChannels() const = 0;
     virtual int getNumSamples() const = 0;
     
-    /** @returns a non-modifiable reference to the multichannel data */
+    /**
+     * @returns a non-modifiable reference to the multichannel data, as one contiguous array per channel.
+     * @note Adapters whose channels are not contiguous in memory (e.g. interleaved signals with more than one channel)
+     * return nullptr -- use getChannelView(), which is available for every signal.
+     */
     virtual const float* const* getData() const = 0;
     
     /** @returns a copy of the data of the given channelIndex (0-based) */
     virtual std::vector<float> getChannelDataCopy(int channelIndex) const = 0;
+    
+    /**
+     * @returns a non-owning view of the data of the given channelIndex (0-based). Prefer this over
+     * getChannelDataCopy() unless the data needs to be modified.
+     */
+    virtual ChannelView getChannelView(int channelIndex) const
+    {
+        SLB_ASSERT(channelIndex >= 0 && channelIndex < getNumChannels(), "invalid channel index");
+        SLB_ASSERT(getData() != nullptr, "signals without getData() have to override getChannelView()");
+        return { getData()[channelIndex], getNumSamples() };
+    }
 };
 
 /**
@@ -93,5 +157,100 @@ private:
     std::vector<const float*> m_channelPointers;
 };
 
+/**
+ * Adapts an interleaved signal (e.g. an audio driver or host buffer: L R L R ...) to the Signal Interface, without
+ * deinterleaving it: every channel is a strided view onto the buffer.
+ *
+ * @note getData() is only available for a single channel, otherwise it returns nullptr -- use getChannelView().
+ */
+class SignalAdapterInterleaved : public ISignal
+{
+public:
+    explicit SignalAdapterInterleaved(const float* interleavedSignal, int numChannels, int numSamples) :
+        m_numChannels(numChannels),
+        m_numSamples(numSamples),
+        m_signal(interleavedSignal)
+    {
+        SLB_ASSERT(numChannels > 0, "invalid number of channels");
+        SLB_ASSERT(numSamples >= 0, "invalid number of samples");
+    }
+    
+    /** @note This object holds a reference to the input data --  will not compile when given an rvalue */
+    explicit SignalAdapterInterleaved(const std::vector<float>& interleavedSignal, int numChannels) :
+        SignalAdapterInterleaved(interleavedSignal.data(), numChannels, numChannels > 0 ? static_cast<int>(interleavedSignal.size()) / numChannels : 0)
+    {
+        SLB_ASSERT(interleavedSignal.size() % numChannels == 0, "Buffer size has to be a multiple of the number of channels");
+    }
+    explicit SignalAdapterInterleaved(const std::vector<float>&& interleavedSignal, int numChannels) = delete;
+    
+    int getNumChannels() const override { return m_numChannels; }
+    int getNumSamples()  const override { return m_numSamples; }
+    const float* const* getData() const override { return m_numChannels == 1 ? &m_signal : nullptr; }
+    std::vector<float> getChannelDataCopy(int channelIndex) const override { return getChannelView(channelIndex).copy(); }
+    ChannelView getChannelView(int channelIndex) const override
+    {
+        SLB_ASSERT(channelIndex >= 0 && channelIndex < getNumChannels(), "invalid channel index");
+        return { m_signal + channelIndex, m_numSamples, m_numChannels };
+    }
+    
+private:
+    const int m_numChannels;
+    const int m_numSamples;
+    const float* m_signal;
+};
+
+/**
+ * Adapts a set of channel views (of equal length) to the Signal Interface -- e.g. to represent a block of a longer
+ * signal, or channels that are scattered across memory.
+ *
+ * @note getData() is only available if all views are contiguous, otherwise it returns nullptr.
+ */
+class SignalAdapterChannelViews : public ISignal
+{
+public:
+    explicit SignalAdapterChannelViews(std::vector<ChannelView> channelViews) :
+        m_channelViews(std::move(channelViews)),
+        m_channelPointers(m_channelViews.size())
+    {
+        for (int i = 0; i < static_cast<int>(m_channelViews.size()); ++i) {
+            SLB_ASSERT(m_channelViews[i].size() == m_channelViews[0].size(), "All channels should be of equal length!");
+            m_channelPointers[i] = m_channelViews[i].data();
+            m_isContiguous &= m_channelViews[i].isContiguous();
+        }
+    }
+    
+    int getNumChannels() const override { return static_cast<int>(m_channelViews.size()); }
+    int getNumSamples()  const override { return m_channelViews.empty() ? 0 : m_channelViews[0].size(); }
+    const float* const* getData() const override { return m_isContiguous ? m_channelPointers.data() : nullptr; }
+    std::vector<float> getChannelDataCopy(int channelIndex) const override { return getChannelView(channelIndex).copy(); }
+    ChannelView getChannelView(int channelIndex) const override
+    {
+        SLB_ASSERT(channelIndex >= 0 && channelIndex < getNumChannels(), "invalid channel index");
+        return m_channelViews[channelIndex];
+    }
+    
+private:
+    std::vector<ChannelView> m_channelViews;
+    std::vector<const float*> m_channelPointers;
+    bool m_isContiguous = true;
+};
+
+/**
+ * Samples per block of the block-wise passes over a signal (the fused pass of checkAll, streaming evaluation, lockstep
+ * channel comparison): small enough to stay in cache, large enough to amortize the per-block overhead.
+ */
+constexpr int evaluationBlockSize = 1024;
+
+/** @returns a block of the given signal (all channels), without copying the data */
+static inline SignalAdapterChannelViews getSignalBlock(const ISignal& signal, int offset, int numSamples)
+{
+    std::vector<ChannelView> channelViews;
+    channelViews.reserve(signal.getNumChannels());
+    for (int channelIndex = 0; channelIndex < signal.getNumChannels(); ++channelIndex) {
+        channelViews.push_back(signal.getChannelView(channelIndex).subView(offset, numSamples));
+    }
+    return SignalAdapterChannelViews(std::move(channelViews));
+}
+
 } // namespace AudioTraits
 } // namespace slb
@@ -0,0 +1,140 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "SampleTypes.hpp"
+#include "SignalAdapters.hpp"
+#include "Utils.hpp"
+
+namespace slb {
+namespace AudioTraits {
+
+/** Memory layouts of a StaticSignal */
+namespace Layout
+{
+struct Planar {};       // one buffer per channel (e.g. float**)
+struct Interleaved {};  // one buffer with the channels' samples alternating (e.g. L R L R ...)
+} // namespace Layout
+
+/**
+ * A signal whose memory layout and sample type are known at compile time. It is a (final) ISignal, so it can be passed
+ * anywhere a signal is expected -- but when it is passed to check<F>() directly, the time-domain traits are
+ * instantiated for this type: channel access is resolved statically and inlined into the trait, and for planar data
+ * the contiguous kernels are selected at compile time.
+ *
+ *     StaticSignal<Layout::Interleaved> signal(buffer, numChannels, numSamples);
+ *     check<HasSignalOnAllChannels>(signal, {});
+ *
+ * Samples of other types than float (double, int16_t, Int24, int32_t -- see SampleConversion) are converted to float:
+ * check<F>() converts them block by block for traits with an Accumulator, so no converted copy of the signal is made.
+ *
+ * @note The ISignal path does make a copy: a ChannelView points to float samples, so getChannelView() converts the
+ * entire channel into a float buffer on first access, and keeps it for the lifetime of this object (one float per
+ * sample for every channel accessed -- e.g. frequency-domain traits, or a StaticSignal passed as an ISignal&).
+ * getChannelDataCopy() converts directly into the returned vector, without keeping a buffer.
+ *
+ * @note This object holds a pointer to the data, which must outlive it.
+ */
+template<typename L, typename T = float>
+class StaticSignal final : public ISignal
+{
+    static_assert(std::is_same<L, Layout::Planar>::value || std::is_same<L, Layout::Interleaved>::value, "Unknown layout");
+    static_assert(IsSupportedSampleType<T>::value, "Unsupported sample type");
+
+    /** planar: T* const*, interleaved: T* */
+    using Data = typename std::conditional<std::is_same<L, Layout::Planar>::value, const T* const*, const T*>::type;
+    using IsFloat = std::is_same<T, float>;
+
+public:
+    using SampleType = T;
+
+    StaticSignal(Data data, int numChannels, int numSamples) :
+        m_data(data),
+        m_numChannels(numChannels),
+        m_numSamples(numSamples),
+        m_convertedChannels(IsFloat::value ? 0 : std::max(numChannels, 0))
+    {
+        SLB_ASSERT(numChannels > 0, "invalid number of channels");
+        SLB_ASSERT(numSamples >= 0, "invalid number of samples");
+    }
+
+    int getNumChannels() const override { return m_numChannels; }
+    int getNumSamples()  const override { return m_numSamples; }
+    const float* const* getData() const override { return getDataPointers(L{}, IsFloat{}); }
+    std::vector<float> getChannelDataCopy(int channelIndex) const override
+    {
+        SLB_ASSERT(channelIndex >= 0 && channelIndex < m_numChannels, "invalid channel index");
+        return makeChannelDataCopy(channelIndex, IsFloat{});
+    }
+    ChannelView getChannelView(int channelIndex) const override
+    {
+        SLB_ASSERT(channelIndex >= 0 && channelIndex < m_numChannels, "invalid channel index");
+        return makeChannelView(channelIndex, IsFloat{});
+    }
+
+    /** @returns the first sample of the channel in its original type -- see getStride() */
+    const T* getChannelStart(int channelIndex) const { return getChannelStart(channelIndex, L{}); }
+
+    /** @returns the distance between consecutive samples of a channel (in samples) */
+    int getStride() const { return std::is_same<L, Layout::Planar>::value ? 1 : m_numChannels; }
+
+private:
+    const T* getChannelStart(int channelIndex, Layout::Planar) const { return m_data[channelIndex]; }
+    const T* getChannelStart(int channelIndex, Layout::Interleaved) const { return m_data + channelIndex; }
+
+    const float* const* getDataPointers(Layout::Planar, std::true_type /*isFloat*/) const { return m_data; }
+    const float* const* getDataPointers(Layout::Interleaved, std::true_type /*isFloat*/) const { return m_numChannels == 1 ? &m_data : nullptr; }
+    const float* const* getDataPointers(L, std::false_type /*isFloat*/) const { return nullptr; }
+
+    ChannelView makeChannelView(int channelIndex, std::true_type /*isFloat*/) const
+    {
+        return { getChannelStart(channelIndex), m_numSamples, getStride() };
+    }
+
+    std::vector<float> makeChannelDataCopy(int channelIndex, std::true_type /*isFloat*/) const
+    {
+        return makeChannelView(channelIndex, std::true_type{}).copy();
+    }
+
+    std::vector<float> makeChannelDataCopy(int channelIndex, std::false_type /*isFloat*/) const
+    {
+        std::vector<float> channelData(m_numSamples);
+        convertToFloat(getChannelStart(channelIndex), getStride(), m_numSamples, channelData.data());
+        return channelData;
+    }
+
+    /** Converts the entire channel on first access (see class documentation) */
+    ChannelView makeChannelView(int channelIndex, std::false_type /*isFloat*/) const
+    {
+        std::lock_guard<std::mutex> lock(m_conversionMutex);
+        std::unique_ptr<std::vector<float>>& converted = m_convertedChannels[channelIndex];
+        if (converted == nullptr) {
+            converted.reset(new std::vector<float>(m_numSamples));
+            convertToFloat(getChannelStart(channelIndex), getStride(), m_numSamples, converted->data());
+        }
+        return { converted->data(), m_numSamples };
+    }
+
+    Data m_data;
+    int m_numChannels;
+    int m_numSamples;
+
+    // only for sample types other than float
+    mutable std::vector<std::unique_ptr<std::vector<float>>> m_convertedChannels;
+    mutable std::mutex m_conversionMutex;
+};
+
+} // namespace AudioTraits
+} // namespace slb
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdlib>
 #include <cmath>
 #include <limits>
@@ -90,6 +91,12 @@ static inline float linear2Db(float value_linear)
     return std::numeric_limits<float>::lowest();
 }
 
+/** Power quantities (e.g. squared magnitudes) use 10*log10 */
+static inline float dB2Power(float value_dB)
+{
+    return std::pow(10.f, (value_dB/10.f));
+}
+
 /**
  * @note from: http://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2
  */
@@ -110,6 +117,15 @@ constexpr bool isPowerOfTwo(uint32_t v)
     return v && ((v & (v - 1)) == 0);
 }
 
+/**
+ * @returns the distance (in elements) of sample 'sampleIndex' from the first sample, if samples are 'stride' elements apart.
+ * @note calculated in std::ptrdiff_t: for long interleaved signals with many channels, it exceeds the range of int.
+ */
+constexpr std::ptrdiff_t stridedOffset(int sampleIndex, int stride)
+{
+    return static_cast<std::ptrdiff_t>(sampleIndex) * stride;
+}
+
 } // namespace Utils
 
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch2/catch.hpp>
 
 /* Macro to detect if exceptions are disabled (works on GCC, Clang and MSVC) 3 */
@@ -8,5 +8,6 @@
 
 // Let Catch provide main():
 #define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_ENABLE_BENCHMARKING // run with '[!benchmark]' to include the benchmarks
 
 #include <catch2/catch.hpp>
@@ -306,3 +306,231 @@ TEST_CASE("AudioTraits::FrequencyDomain: noise tests")
         REQUIRE_FALSE(check<HasSignalOnlyInBands>(noise, {}, Freqs{{lowerFreq*1.1f, upperFreq*0.9f}}, sampleRate, thrs));
     }
 }
+
+TEST_CASE("AudioTraits::FrequencyDomain: FFT length")
+{
+    constexpr float sampleRate = 48e3f;
+    int signalLength = static_cast<int>(sampleRate) * 1;
+    
+    auto sine1kSignal = SignalGenerator::createSine<float>(1000, sampleRate, signalLength);
+    auto sine6kSignal = SignalGenerator::createSine<float>(6000, sampleRate, signalLength);
+    std::vector<std::vector<float>> sineData {sine1kSignal, sine6kSignal};
+    SignalAdapterStdVecVec sine(sineData);
+    
+    SECTION("Invalid FFT lengths") {
+        for (int fftLength : {-1, 0, 8, 100, 4095, 32767, 1 << 21}) {
+            REQUIRE_THROWS(check<HasSignalInAllBands>(sine, {1}, Freqs{1000}, sampleRate, -0.5f, fftLength));
+            REQUIRE_THROWS(check<HasSignalOnlyInBands>(sine, {1}, Freqs{1000}, sampleRate, -0.5f, fftLength));
+            REQUIRE_THROWS(FrequencyDomainHelpers::determineCorrespondingBins(FreqBand{1000}, sampleRate, fftLength));
+        }
+    }
+    
+    SECTION("Bins depend on the FFT length") {
+        REQUIRE(FrequencyDomainHelpers::getNumBins(16) == 9);
+        REQUIRE(FrequencyDomainHelpers::getNumBins(16384) == 8193);
+        REQUIRE(FrequencyDomainHelpers::determineCorrespondingBins(FreqBand{1000}, sampleRate) == BinRange{85, 86});
+        REQUIRE(FrequencyDomainHelpers::determineCorrespondingBins(FreqBand{1000}, sampleRate, 4096) == BinRange{85, 86});
+        REQUIRE(FrequencyDomainHelpers::determineCorrespondingBins(FreqBand{1000}, sampleRate, 256) == BinRange{5, 6});
+        REQUIRE(FrequencyDomainHelpers::determineCorrespondingBins(FreqBand{1000}, sampleRate, 16384) == BinRange{341, 342});
+        REQUIRE(FrequencyDomainHelpers::determineCorrespondingBins(FreqBand{sampleRate/2}, sampleRate, 16) == BinRange{8, 8});
+    }
+    
+    SECTION("Chunks are read from the channel without modifying it") {
+        // 2.5 chunks: the tail is zero-padded
+        const std::vector<float> channel(sine1kSignal.begin(), sine1kSignal.begin() + 2560);
+        const std::vector<float> channelCopy = channel;
+        std::vector<float> padded = channel;
+        padded.resize(3072, 0.f);
+        const std::vector<float> binValues = FrequencyDomainHelpers::getNormalizedBinValues(channel, 1024);
+        REQUIRE(channel == channelCopy);
+        REQUIRE(binValues == FrequencyDomainHelpers::getNormalizedBinValues(padded, 1024));
+        
+        // strided (interleaved) channel
+        std::vector<float> interleaved;
+        for (float sample : channel) {
+            interleaved.push_back(0.f);
+            interleaved.push_back(sample);
+        }
+        REQUIRE(binValues == FrequencyDomainHelpers::getNormalizedBinValues(ChannelView(interleaved.data() + 1, 2560, 2), 1024));
+    }
+    
+    SECTION("Power scale") {
+        // a single chunk: the powers are the squared magnitudes
+        const ChannelView chunk(sine1kSignal.data(), 4096);
+        const std::vector<float> magnitudes = FrequencyDomainHelpers::getNormalizedBinValues(chunk, 4096);
+        const std::vector<float> powers = FrequencyDomainHelpers::getNormalizedBinValues(chunk, 4096, WindowType::Hann,
+                                                                                          FrequencyDomainHelpers::BinScale::Power);
+        REQUIRE(powers.size() == magnitudes.size());
+        for (int k = 0; k < static_cast<int>(powers.size()); ++k) {
+            REQUIRE(powers[k] == Approx(magnitudes[k] * magnitudes[k]).margin(1e-6f));
+        }
+        REQUIRE(FrequencyDomainHelpers::binValueForThreshold(-6.f) == Approx(0.501187f));
+        REQUIRE(FrequencyDomainHelpers::binValueForThreshold(-6.f, FrequencyDomainHelpers::BinScale::Power) == Approx(0.251189f));
+        REQUIRE(FrequencyDomainHelpers::binValueForThreshold(0.f, FrequencyDomainHelpers::BinScale::Power) == 1.f);
+    }
+    
+    SECTION("All supported lengths") {
+        int fftLength = GENERATE(range(4, 15));
+        fftLength = 1 << fftLength;
+        REQUIRE(check<HasSignalOnlyBelow>(sine, {1}, 1500, sampleRate, -0.5f, fftLength));
+        REQUIRE(check<HasSignalOnlyAbove>(sine, {2}, 5000, sampleRate, -0.5f, fftLength));
+        REQUIRE_FALSE(check<HasSignalOnlyBelow>(sine, {2}, 1500, sampleRate, -0.5f, fftLength));
+        REQUIRE(FrequencyDomainHelpers::getNormalizedBinValues(sine.getChannelView(0), fftLength).size() == fftLength/2 + 1);
+    }
+    
+    SECTION("Resolution") {
+        // coarse: 1100 Hz is within the same bins as 1000 Hz
+        REQUIRE(check<HasSignalOnlyInBands>(sine, {1}, Freqs{1100}, sampleRate, -0.5f, 256));
+        REQUIRE_FALSE(check<HasSignalOnlyInBands>(sine, {1}, Freqs{1100}, sampleRate));
+        
+        // fine: +7Hz is outside the bins at 16384, but within at the default of 4096
+        REQUIRE(check<HasSignalOnlyInBands>(sine, {1}, Freqs{1007}, sampleRate));
+        REQUIRE(check<HasSignalInAllBands>(sine, {1}, Freqs{1000}, sampleRate, -0.5f, 16384));
+        REQUIRE(check<HasSignalOnlyInBands>(sine, {1}, Freqs{1000}, sampleRate, -0.5f, 16384));
+        REQUIRE_FALSE(check<HasSignalOnlyInBands>(sine, {1}, Freqs{1007}, sampleRate, -0.5f, 16384));
+        
+        // very fine: at 65536, the bins are 0.73 Hz apart
+        std::vector<std::vector<float>> longSineData { SignalGenerator::createSine<float>(1000, sampleRate, 65536) };
+        SignalAdapterStdVecVec longSine(longSineData);
+        REQUIRE(check<HasSignalOnlyInBands>(longSine, {1}, Freqs{1000}, sampleRate, -0.5f, 65536));
+        REQUIRE(check<HasSignalOnlyInBands>(longSine, {1}, Freqs{1001}, sampleRate, -0.5f, 16384));
+        REQUIRE_FALSE(check<HasSignalOnlyInBands>(longSine, {1}, Freqs{1001}, sampleRate, -0.5f, 65536));
+    }
+    
+    SECTION("Spectra with different FFT lengths are cached separately") {
+        AnalyzedSignal analyzedSine(sine);
+        REQUIRE(check<HasSignalInAllBands>(analyzedSine, {1}, Freqs{1000}, sampleRate, -0.5f, 1024));
+        REQUIRE(analyzedSine.getSpectrumCache().getNumEntries() == 1);
+        REQUIRE(check<HasSignalOnlyInBands>(analyzedSine, {1}, Freqs{1000}, sampleRate, -0.5f, 1024));
+        REQUIRE(analyzedSine.getSpectrumCache().getNumEntries() == 1);
+        REQUIRE(check<HasSignalOnlyInBands>(analyzedSine, {1}, Freqs{1000}, sampleRate));
+        REQUIRE(analyzedSine.getSpectrumCache().getNumEntries() == 2);
+        REQUIRE(analyzedSine.getNormalizedBinValues(0, 1024).size() == 513);
+        REQUIRE(analyzedSine.getNormalizedBinValues(0).size() == 2049);
+    }
+}
+
+TEST_CASE("AudioTraits::FrequencyDomain: spectrum cache")
+{
+    constexpr float sampleRate = 48e3f;
+    int signalLength = static_cast<int>(sampleRate) * 1;
+    
+    auto sine1kSignal = SignalGenerator::createSine<float>(1000, sampleRate, signalLength);
+    auto sine2kSignal = SignalGenerator::createSine<float>(2000, sampleRate, signalLength);
+    auto sine6kSignal = SignalGenerator::createSine<float>(6000, sampleRate, signalLength);
+    std::vector<std::vector<float>> sineData {sine1kSignal, sine2kSignal, sine6kSignal};
+    SignalAdapterStdVecVec sine(sineData);
+    AnalyzedSignal analyzedSine(sine);
+    
+    REQUIRE(analyzedSine.getNumChannels() == sine.getNumChannels());
+    REQUIRE(analyzedSine.getNumSamples() == sine.getNumSamples());
+    REQUIRE(analyzedSine.getData() == sine.getData());
+    REQUIRE(analyzedSine.getSpectrumCache().getNumEntries() == 0);
+    static_assert(std::is_constructible<AnalyzedSignal, SignalAdapterStdVecVec>::value == false, "cannot wrap an r-value");
+
+    SECTION("Results match the uncached evaluation") {
+        REQUIRE(check<HasSignalInAllBands>(analyzedSine, {1}, Freqs{1000}, sampleRate) == check<HasSignalInAllBands>(sine, {1}, Freqs{1000}, sampleRate));
+        REQUIRE(check<HasSignalOnlyInBands>(analyzedSine, {}, Freqs{{1000, 6000}}, sampleRate) == check<HasSignalOnlyInBands>(sine, {}, Freqs{{1000, 6000}}, sampleRate));
+        REQUIRE(check<HasSignalOnlyInBands>(analyzedSine, {}, Freqs{{2000, 6000}}, sampleRate) == check<HasSignalOnlyInBands>(sine, {}, Freqs{{2000, 6000}}, sampleRate));
+        REQUIRE(check<HasSignalOnlyBelow>(analyzedSine, {1, 2}, 2500, sampleRate) == check<HasSignalOnlyBelow>(sine, {1, 2}, 2500, sampleRate));
+        REQUIRE(check<HasSignalOnlyAbove>(analyzedSine, {3}, 5000, sampleRate) == check<HasSignalOnlyAbove>(sine, {3}, 5000, sampleRate));
+        
+        for (int channelIndex = 0; channelIndex < sine.getNumChannels(); ++channelIndex) {
+            std::vector<float> channelSignal = sine.getChannelDataCopy(channelIndex);
+            REQUIRE(analyzedSine.getNormalizedBinValues(channelIndex) == FrequencyDomainHelpers::getNormalizedBinValues(channelSignal));
+        }
+    }
+    
+    SECTION("Every channel is analyzed only once") {
+        REQUIRE(check<HasSignalInAllBands>(analyzedSine, {1}, Freqs{{1000}, {900, 1100}}, sampleRate));
+        REQUIRE(analyzedSine.getSpectrumCache().getNumEntries() == 1);
+        REQUIRE(check<HasSignalOnlyInBands>(analyzedSine, {1}, Freqs{1000}, sampleRate));
+        REQUIRE(analyzedSine.getSpectrumCache().getNumEntries() == 1);
+        REQUIRE(check<HasSignalOnlyBelow>(analyzedSine, {}, 6500, sampleRate));
+        REQUIRE(analyzedSine.getSpectrumCache().getNumEntries() == 3);
+        REQUIRE_FALSE(check<HasSignalOnlyAbove>(analyzedSine, {}, 1500, sampleRate));
+        REQUIRE(analyzedSine.getSpectrumCache().getNumEntries() == 3);
+    }
+    
+    SECTION("Standalone cache is keyed on the channel data") {
+        SpectrumCache cache;
+        SignalAdapterStdVecVec sameData(sineData);
+        const std::vector<float>& binValues = cache.getNormalizedBinValues(sine, 0);
+        REQUIRE(&cache.getNormalizedBinValues(sameData, 0) == &binValues); // same underlying data -> same entry
+        REQUIRE(cache.getNumEntries() == 1);
+        cache.getNormalizedBinValues(sine, 1);
+        REQUIRE(cache.getNumEntries() == 2);
+        REQUIRE_THROWS(cache.getNormalizedBinValues(sine, 3));
+        cache.clear();
+        REQUIRE(cache.getNumEntries() == 0);
+
+        // same start address and length, but every other sample -> different entry
+        const int numSamples = static_cast<int>(sineData[0].size()) / 2;
+        SignalAdapterInterleaved mono(sineData[0].data(), 1, numSamples);
+        SignalAdapterInterleaved stereo(sineData[0].data(), 2, numSamples);
+        const std::vector<float>& monoBinValues = cache.getNormalizedBinValues(mono, 0);
+        REQUIRE(&cache.getNormalizedBinValues(stereo, 0) != &monoBinValues);
+        REQUIRE(cache.getNumEntries() == 2);
+        REQUIRE(cache.getNormalizedBinValues(stereo, 0) == FrequencyDomainHelpers::getNormalizedBinValues(stereo.getChannelView(0)));
+    }
+}
+
+TEST_CASE("AudioTraits::FrequencyDomain: bin masks")
+{
+    SECTION("Ranges are merged") {
+        BinMask mask;
+        REQUIRE(mask.isEmpty());
+        mask.add({10, 12});
+        mask.add({2, 4});
+        mask.add({20, 20});
+        REQUIRE(mask.getRanges() == std::vector<BinRange>{{2, 4}, {10, 12}, {20, 20}});
+        mask.add({5, 6}); // adjacent
+        mask.add({11, 19}); // overlapping, adjacent
+        REQUIRE(mask.getRanges() == std::vector<BinRange>{{2, 6}, {10, 20}});
+        mask.add({0, 30});
+        REQUIRE(mask == BinMask{{0, 30}});
+        REQUIRE(mask.getNumBins() == 31);
+        REQUIRE_THROWS(mask.add({5, 4}));
+        REQUIRE_THROWS(mask.add({-1, 4}));
+    }
+    
+    SECTION("Membership") {
+        BinMask mask {{3, 5}, {9, 9}};
+        std::vector<int> containedBins;
+        for (int bin = 0; bin < 12; ++bin) {
+            if (mask.contains(bin)) {
+                containedBins.push_back(bin);
+            }
+        }
+        REQUIRE(containedBins == std::vector<int>{3, 4, 5, 9});
+        REQUIRE(mask.getNumBins() == 4);
+    }
+    
+    SECTION("Mask of a frequency selection") {
+        constexpr float sampleRate = 48e3f;
+        BinMask mask = FrequencyDomainHelpers::determineCorrespondingBins(Freqs{1000, {900, 1100}, 5000}, sampleRate, 256);
+        REQUIRE(mask == BinMask{{4, 6}, {26, 27}});
+        REQUIRE(FrequencyDomainHelpers::determineBinsPerBand(Freqs{1000, {900, 1100}}, sampleRate, 256)
+                == std::vector<BinRange>{{5, 6}, {4, 6}});
+    }
+    
+    SECTION("Bin scans") {
+        std::vector<float> bins(64, 0.f);
+        bins[1] = 0.1f;
+        bins[2] = 1.f;
+        bins[3] = 0.2f;
+        bins[5] = 0.5f;
+        bins[7] = 0.3f;
+        REQUIRE(FrequencyDomainHelpers::maxOutsideMask(bins, BinMask{}) == 1.f);
+        REQUIRE(FrequencyDomainHelpers::maxOutsideMask(bins, BinMask{{2, 2}}) == 0.5f);
+        REQUIRE(FrequencyDomainHelpers::maxOutsideMask(bins, BinMask{{2, 5}}) == 0.3f);
+        REQUIRE(FrequencyDomainHelpers::maxOutsideMask(bins, BinMask{{0, 5}, {7, 7}}) == 0.f);
+        REQUIRE(FrequencyDomainHelpers::maxOutsideMask(bins, BinMask{{0, 100}}) == 0.f);
+        
+        REQUIRE(FrequencyDomainHelpers::anyInsideEachBand(bins, {{2, 2}, {5, 7}}, 0.49f));
+        REQUIRE_FALSE(FrequencyDomainHelpers::anyInsideEachBand(bins, {{2, 2}, {5, 7}}, 0.51f));
+        REQUIRE_FALSE(FrequencyDomainHelpers::anyInsideEachBand(bins, {{2, 2}, {4, 4}}, 0.001f));
+        REQUIRE(FrequencyDomainHelpers::anyInsideEachBand(bins, {}, 1.f));
+        REQUIRE_THROWS(FrequencyDomainHelpers::anyInsideEachBand(bins, {{2, 64}}, 0.f));
+    }
+}
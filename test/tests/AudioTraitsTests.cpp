@@ -10,6 +10,7 @@
 #include "SignalGenerator.hpp"
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 #ifdef SLB_AMALGATED_HEADER
@@ -308,6 +309,64 @@ TEST_CASE("AudioTraits::HasIdenticalChannels Tests")
     REQUIRE_FALSE(check<HasIdenticalChannels>(signal, {4, 6}, 2.999f));
 }
 
+TEST_CASE("AudioTraits::HasIdenticalChannels Tests - many channels")
+{
+    constexpr int numChannels = 32;
+    constexpr int numSamples = 5000; // several blocks, with remainder
+    std::vector<float> noise = SignalGenerator::createWhiteNoise(numSamples, -6.f, 42 /*seed*/);
+    std::vector<std::vector<float>> buffer(numChannels, noise);
+    SignalAdapterStdVecVec signal(buffer);
+    
+    REQUIRE(check<HasIdenticalChannels>(signal, {}));
+    
+    // a mismatch in any channel but the last must not be masked by the channels after it
+    int mismatchChannel = GENERATE(2, 16, 31, 32);
+    int mismatchSample = GENERATE(0, 1023, 1024, numSamples - 1);
+    buffer[mismatchChannel - 1][mismatchSample] *= 2.f;
+    REQUIRE_FALSE(check<HasIdenticalChannels>(signal, {}));
+    REQUIRE_FALSE(check<HasIdenticalChannels>(signal, {1, mismatchChannel}));
+    REQUIRE(check<HasIdenticalChannels>(signal, {1, mismatchChannel}, 6.03f));
+    REQUIRE(check<HasIdenticalChannels>(signal, {mismatchChannel}));
+    
+    // mismatch is in the reference channel
+    buffer[mismatchChannel - 1][mismatchSample] = noise[mismatchSample];
+    buffer[0][mismatchSample] *= 2.f;
+    REQUIRE_FALSE(check<HasIdenticalChannels>(signal, {}));
+    REQUIRE(check<HasIdenticalChannels>(signal, {2, 3, numChannels}));
+}
+
+TEST_CASE("AudioTraits::HasIdenticalChannels Benchmark", "[!benchmark]")
+{
+    constexpr int numChannels = 64;
+    constexpr int numSamples = 48000;
+    std::vector<float> noise = SignalGenerator::createWhiteNoise(numSamples, -6.f, 42 /*seed*/);
+    std::vector<std::vector<float>> buffer(numChannels, noise);
+    SignalAdapterStdVecVec signal(buffer);
+    
+    // The previous implementation: every channel is copied and compared to the reference in full, in dB
+    auto copyAndCompareAll = [&signal]()
+    {
+        constexpr float tolerance_dB = 0.f;
+        bool doAllChannelsMatch = true;
+        std::vector<float> reference = signal.getChannelDataCopy(0);
+        for (int ch = 1; ch < numChannels; ++ch) {
+            std::vector<float> channelSignal = signal.getChannelDataCopy(ch);
+            doAllChannelsMatch = std::equal(channelSignal.begin(), channelSignal.end(), reference.begin(), [](float a, float b)
+            {
+                return std::abs(Utils::linear2Db(std::abs(a)) - Utils::linear2Db(std::abs(b))) <= tolerance_dB;
+            });
+        }
+        return doAllChannelsMatch;
+    };
+    
+    BENCHMARK("Identical channels: copy & compare") { return copyAndCompareAll(); };
+    BENCHMARK("Identical channels: lockstep") { return check<HasIdenticalChannels>(signal, {}); };
+    
+    buffer[1][100] = 1.f; // early mismatch
+    BENCHMARK("Early mismatch: copy & compare") { return copyAndCompareAll(); };
+    BENCHMARK("Early mismatch: lockstep") { return check<HasIdenticalChannels>(signal, {}); };
+}
+
 TEST_CASE("AudioTraits::HaveIdenticalChannels Tests")
 {
     std::vector<float> data1A = SignalGenerator::createWhiteNoise(16, 0.f, 333 /*seed*/);
@@ -343,4 +402,17 @@ TEST_CASE("AudioTraits::HaveIdenticalChannels Tests")
     REQUIRE_FALSE(check<HaveIdenticalChannels>(signalA, {1, {4, 6}}, signalB));
     REQUIRE(check<HaveIdenticalChannels>(signalA, {1, {4, 6}}, signalB, 3.001f));
     REQUIRE_FALSE(check<HaveIdenticalChannels>(signalA, {1, {4, 6}}, signalB, 2.999f));
+    
+    // a NaN sample never matches -- in the vectorized part or in the remainder
+    for (int numSamples : {1, 64, 1000}) {
+        std::vector<std::vector<float>> reference(1, std::vector<float>(numSamples, 0.5f));
+        SignalAdapterStdVecVec referenceSignal(reference);
+        for (int position : {0, numSamples / 2, numSamples - 1}) {
+            std::vector<std::vector<float>> corrupted = reference;
+            corrupted[0][position] = std::numeric_limits<float>::quiet_NaN();
+            SignalAdapterStdVecVec corruptedSignal(corrupted);
+            REQUIRE_FALSE(check<HaveIdenticalChannels>(corruptedSignal, {}, referenceSignal));
+            REQUIRE_FALSE(check<HaveIdenticalChannels>(referenceSignal, {}, corruptedSignal, 90.f));
+        }
+    }
 }
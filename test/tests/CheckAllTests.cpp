@@ -0,0 +1,174 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//  
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#include "TestCommon.hpp"
+#include "SignalGenerator.hpp"
+
+#include <array>
+#include <vector>
+
+#ifdef SLB_AMALGATED_HEADER
+    #include "AudioTraits.hpp"
+#else
+    #include "AudioTraits.hpp"
+#endif
+
+using namespace slb;
+using namespace slb::AudioTraits;
+using namespace TestCommon;
+
+namespace
+{
+/** Counts how many blocks were processed */
+struct CountsBlocks
+{
+    static bool eval(const ISignal&, const std::set<int>&, int&) { return true; }
+    
+    class Accumulator
+    {
+    public:
+        Accumulator(const std::set<int>&, int& numBlocks) : m_numBlocks(numBlocks) {}
+        void process(const ISignal&) { m_numBlocks++; }
+        bool isDecided() const { return false; }
+        bool finish() const { return true; }
+    private:
+        int& m_numBlocks;
+    };
+};
+
+/** Records whether it was evaluated on an AnalyzedSignal */
+struct SeesAnalyzedSignal
+{
+    static bool eval(const ISignal& signal, const std::set<int>&, bool& isAnalyzedSignal)
+    {
+        isAnalyzedSignal = dynamic_cast<const AnalyzedSignal*>(&signal) != nullptr;
+        return true;
+    }
+};
+} // namespace
+
+TEST_CASE("checkAll Tests")
+{
+    constexpr float sampleRate = 48e3f;
+    constexpr int signalLength = 10000; // several blocks, with remainder
+    
+    auto sine1k = SignalGenerator::createSine<float>(1000, sampleRate, signalLength);
+    auto sine2k = SignalGenerator::createSine<float>(2000, sampleRate, signalLength);
+    auto silence = SignalGenerator::createSilence<float>(signalLength);
+    std::vector<std::vector<float>> buffer { sine1k, sine1k, sine2k, silence };
+    SignalAdapterStdVecVec signal(buffer);
+    std::vector<std::vector<float>> otherBuffer { sine1k, sine2k, sine2k, silence };
+    SignalAdapterStdVecVec otherSignal(otherBuffer);
+    
+    SECTION("Results match the individual checks") {
+        for (const ChannelSelection& channels : {ChannelSelection{}, ChannelSelection{1}, ChannelSelection{1, 2},
+                                                 ChannelSelection{{1, 3}}, ChannelSelection{3, 4}}) {
+            auto results = checkAll(signal, channels,
+                                    bind<HasSignalOnAllChannels>(),
+                                    bind<HasSignalOnAllChannels>(3.f),
+                                    bind<HasIdenticalChannels>(),
+                                    bind<HaveIdenticalChannels>(otherSignal),
+                                    bind<HaveIdenticalChannels>(signal, 1.f),
+                                    bind<IsDelayedVersionOf>(signal, 0),
+                                    bind<HasSignalInAllBands>(Freqs{1000}, sampleRate),
+                                    bind<HasSignalOnlyBelow>(1500.f, sampleRate),
+                                    bind<HasSignalOnlyInBands>(Freqs{{900, 2100}}, sampleRate, -0.5f, 1024));
+            REQUIRE(results.size() == 9);
+            REQUIRE(results[0] == check<HasSignalOnAllChannels>(signal, channels));
+            REQUIRE(results[1] == check<HasSignalOnAllChannels>(signal, channels, 3.f));
+            REQUIRE(results[2] == check<HasIdenticalChannels>(signal, channels));
+            REQUIRE(results[3] == check<HaveIdenticalChannels>(signal, channels, otherSignal));
+            REQUIRE(results[4] == check<HaveIdenticalChannels>(signal, channels, signal, 1.f));
+            REQUIRE(results[5] == check<IsDelayedVersionOf>(signal, channels, signal, 0));
+            REQUIRE(results[6] == check<HasSignalInAllBands>(signal, channels, Freqs{1000}, sampleRate));
+            REQUIRE(results[7] == check<HasSignalOnlyBelow>(signal, channels, 1500.f, sampleRate));
+            REQUIRE(results[8] == check<HasSignalOnlyInBands>(signal, channels, Freqs{{900, 2100}}, sampleRate, -0.5f, 1024));
+        }
+        
+        auto results = checkAll(signal, {1, 2}, bind<HasSignalOnAllChannels>(), bind<HasIdenticalChannels>(),
+                                bind<HasSignalInAllBands>(Freqs{1000}, sampleRate), bind<HasSignalOnlyBelow>(1500.f, sampleRate));
+        REQUIRE(results == std::array<bool, 4>{true, true, true, true});
+        results = checkAll(signal, {}, bind<HasSignalOnAllChannels>(), bind<HasIdenticalChannels>(),
+                           bind<HasSignalInAllBands>(Freqs{1000}, sampleRate), bind<HasSignalOnlyBelow>(1500.f, sampleRate));
+        REQUIRE(results == std::array<bool, 4>{false, false, false, false});
+    }
+    
+    SECTION("Spectra are shared among frequency-domain traits") {
+        AnalyzedSignal analyzedSignal(signal);
+        checkAll(analyzedSignal, {1, 3}, bind<HasSignalInAllBands>(Freqs{1000}, sampleRate), bind<HasSignalOnlyBelow>(3000.f, sampleRate),
+                 bind<HasSignalOnlyAbove>(500.f, sampleRate));
+        REQUIRE(analyzedSignal.getSpectrumCache().getNumEntries() == 2);
+    }
+
+    SECTION("Signal is only analyzed if there are frequency-domain traits") {
+        bool isAnalyzedSignal = true;
+        checkAll(signal, {}, bind<SeesAnalyzedSignal>(isAnalyzedSignal), bind<HasIdenticalChannels>());
+        REQUIRE_FALSE(isAnalyzedSignal);
+        checkAll(signal, {}, bind<SeesAnalyzedSignal>(isAnalyzedSignal), bind<HasSignalOnlyBelow>(3000.f, sampleRate));
+        REQUIRE(isAnalyzedSignal);
+
+        AnalyzedSignal analyzedSignal(signal);
+        checkAll(analyzedSignal, {}, bind<SeesAnalyzedSignal>(isAnalyzedSignal), bind<HasSignalOnlyBelow>(3000.f, sampleRate));
+        REQUIRE(isAnalyzedSignal);
+        REQUIRE(analyzedSignal.getSpectrumCache().getNumEntries() == 4); // the existing analysis is used
+    }
+
+    SECTION("Single pass, which ends when all time-domain results are decided") {
+        int numBlocks = 0;
+        checkAll(signal, {}, bind<CountsBlocks>(numBlocks));
+        REQUIRE(numBlocks == 10);
+        
+        numBlocks = 0;
+        REQUIRE(checkAll(signal, {}, bind<CountsBlocks>(numBlocks), bind<HasSignalOnAllChannels>())[1] == false);
+        REQUIRE(numBlocks == 10);
+        
+        // All decided after the first block (signal is found in the first block / channels differ in the first block)
+        std::vector<float> onlyFirst(signalLength, 0.f);
+        onlyFirst[0] = 1.f;
+        std::vector<std::vector<float>> impulseBuffer { onlyFirst, silence };
+        SignalAdapterStdVecVec impulse(impulseBuffer);
+        auto results = checkAll(impulse, {}, bind<HasSignalOnAllChannels>(), bind<HasIdenticalChannels>());
+        REQUIRE(results == std::array<bool, 2>{false, false});
+        results = checkAll(impulse, {1}, bind<HasSignalOnAllChannels>(), bind<HasIdenticalChannels>());
+        REQUIRE(results == std::array<bool, 2>{true, true});
+    }
+    
+    SECTION("Invalid parameters") {
+        REQUIRE_THROWS(checkAll(signal, {5}, bind<HasSignalOnAllChannels>()));
+        REQUIRE_THROWS(checkAll(signal, {}, bind<HasIdenticalChannels>(-1.f)));
+        std::vector<std::vector<float>> shortBuffer;
+        for (const auto& channel : buffer) {
+            shortBuffer.emplace_back(channel.begin(), channel.begin() + 100);
+        }
+        SignalAdapterStdVecVec shortSignal(shortBuffer);
+        REQUIRE_THROWS(checkAll(signal, {}, bind<HaveIdenticalChannels>(shortSignal)));
+        REQUIRE_THROWS(checkAll(shortSignal, {}, bind<HaveIdenticalChannels>(signal)));
+    }
+}
+
+TEST_CASE("SignalAdapterChannelViews Tests")
+{
+    std::vector<float> interleaved { 1, 10, 2, 20, 3, 30 };
+    SignalAdapterChannelViews strided({ ChannelView(interleaved.data(), 3, 2), ChannelView(interleaved.data() + 1, 3, 2) });
+    REQUIRE(strided.getNumChannels() == 2);
+    REQUIRE(strided.getNumSamples() == 3);
+    REQUIRE(strided.getData() == nullptr);
+    REQUIRE(strided.getChannelDataCopy(1) == std::vector<float>{10, 20, 30});
+    REQUIRE_THROWS(strided.getChannelView(2));
+    
+    std::vector<std::vector<float>> buffer { {1, 2, 3, 4}, {5, 6, 7, 8} };
+    SignalAdapterStdVecVec signal(buffer);
+    SignalAdapterChannelViews block = getSignalBlock(signal, 1, 2);
+    REQUIRE(block.getNumSamples() == 2);
+    REQUIRE(block.getData()[1] == buffer[1].data() + 1);
+    REQUIRE(block.getChannelDataCopy(0) == std::vector<float>{2, 3});
+    REQUIRE(check<HasSignalOnAllChannels>(block, {}, Utils::linear2Db(6.f)) == false);
+    REQUIRE(check<HasSignalOnAllChannels>(block, {}, Utils::linear2Db(2.f)));
+    REQUIRE_THROWS(getSignalBlock(signal, 3, 2));
+    REQUIRE_THROWS(SignalAdapterChannelViews({ ChannelView(interleaved.data(), 3), ChannelView(interleaved.data(), 2) }));
+}
@@ -0,0 +1,172 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//  
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#include "TestCommon.hpp"
+#include "SignalGenerator.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#ifdef SLB_AMALGATED_HEADER
+    #include "AudioTraits.hpp"
+#else
+    #include "AudioTraits.hpp"
+    #include "FrequencyDomain/CrossCorrelation.hpp"
+#endif
+
+using namespace slb;
+using namespace slb::AudioTraits;
+using namespace TestCommon;
+
+/** @returns a copy of the input, delayed by the given amount (negative: advanced), keeping the length */
+static std::vector<float> delayed(const std::vector<float>& input, int delay)
+{
+    std::vector<float> result(input.size(), 0.f);
+    for (int i = 0; i < static_cast<int>(input.size()); ++i) {
+        int sourceIndex = i - delay;
+        if (sourceIndex >= 0 && sourceIndex < static_cast<int>(input.size())) {
+            result[i] = input[sourceIndex];
+        }
+    }
+    return result;
+}
+
+TEST_CASE("CrossCorrelation Tests")
+{
+    SECTION("Matches direct calculation") {
+        int signalLength = GENERATE(1, 20, 333, 5000);
+        int referenceLength = GENERATE(1, 100, 4500);
+        std::vector<float> signal = SignalGenerator::createWhiteNoise(signalLength, 0.f, 1 /*seed*/);
+        std::vector<float> reference = SignalGenerator::createWhiteNoise(referenceLength, 0.f, 2 /*seed*/);
+        
+        for (auto lagRange : std::vector<std::pair<int, int>>{{0, 0}, {-5, 5}, {-100, 3}, {10, 300}, {-3000, 2000}}) {
+            std::vector<float> result = FrequencyDomainHelpers::calculateCrossCorrelation(ChannelView(signal.data(), signalLength),
+                                                                                          ChannelView(reference.data(), referenceLength),
+                                                                                          lagRange.first, lagRange.second);
+            REQUIRE(result.size() == lagRange.second - lagRange.first + 1);
+            
+            for (int lag = lagRange.first; lag <= lagRange.second; lag += 7) {
+                double expected = 0;
+                for (int n = 0; n < referenceLength; ++n) {
+                    if (n + lag >= 0 && n + lag < signalLength) {
+                        expected += signal[n + lag] * reference[n];
+                    }
+                }
+                REQUIRE(result[lag - lagRange.first] == Approx(expected).margin(1e-3));
+            }
+        }
+    }
+    
+    SECTION("A CrossCorrelator can be reused and accumulates") {
+        std::vector<float> signal = SignalGenerator::createWhiteNoise(3000, 0.f, 1 /*seed*/);
+        std::vector<float> reference = SignalGenerator::createWhiteNoise(2000, 0.f, 2 /*seed*/);
+        FrequencyDomainHelpers::CrossCorrelator crossCorrelator(201, 2000);
+        std::vector<float> result(crossCorrelator.getNumLags(), 0.f);
+        for (int referenceLength : {2000, 1, 700, 2000}) {
+            ChannelView signalView(signal.data(), 3000);
+            ChannelView referenceView(reference.data(), referenceLength);
+            std::vector<float> expected = FrequencyDomainHelpers::calculateCrossCorrelation(signalView, referenceView, -100, 100);
+            for (int numCalls = 1; numCalls <= 2; ++numCalls) { // the second call adds to the first one's result
+                if (numCalls == 1) {
+                    std::fill(result.begin(), result.end(), 0.f);
+                }
+                crossCorrelator.accumulate(signalView, referenceView, -100, result.data());
+                for (int k = 0; k < crossCorrelator.getNumLags(); ++k) {
+                    REQUIRE(result[k] == Approx(numCalls * expected[k]).margin(1e-3));
+                }
+            }
+        }
+    }
+    
+    SECTION("Lag range is limited by FFT length") {
+        std::vector<float> signal(100);
+        REQUIRE_THROWS(FrequencyDomainHelpers::calculateCrossCorrelation(ChannelView(signal.data(), 100), ChannelView(signal.data(), 100), 1, 0));
+        REQUIRE(FrequencyDomainHelpers::calculateCrossCorrelation(ChannelView(signal.data(), 100), ChannelView(signal.data(), 100), -10000, 10000).size() == 20001);
+        REQUIRE_THROWS(FrequencyDomainHelpers::calculateCrossCorrelation(ChannelView(signal.data(), 100), ChannelView(signal.data(), 100), -600000, 600000));
+    }
+}
+
+TEST_CASE("estimateDelay Tests")
+{
+    constexpr int signalLength = 48000;
+    std::vector<float> reference = SignalGenerator::createWhiteNoise(signalLength, -6.f, 3 /*seed*/);
+    ChannelView referenceView(reference.data(), signalLength);
+    
+    int delay = GENERATE(0, 1, -1, 17, 480, -480, 3000, -3000);
+    std::vector<float> signal = delayed(reference, delay);
+    ChannelView signalView(signal.data(), signalLength);
+    
+    DelayEstimate estimate = estimateDelay(signalView, referenceView, 4000);
+    REQUIRE(estimate.delay_samples == delay);
+    REQUIRE(estimate.correlation > 0.9f);
+    
+    // search range does not contain the delay -> low correlation
+    DelayEstimate wrongRange = estimateDelay(signalView, referenceView, delay + 10, delay + 100);
+    REQUIRE(wrongRange.correlation < 0.1f);
+    
+    // inverted signal does not correlate positively
+    std::vector<float> inverted = signal;
+    for (auto& s : inverted) { s = -s; }
+    REQUIRE(estimateDelay(ChannelView(inverted.data(), signalLength), referenceView, 4000).correlation < 0.1f);
+    
+    // silence
+    std::vector<float> silence(signalLength, 0.f);
+    REQUIRE(estimateDelay(ChannelView(silence.data(), signalLength), referenceView, 100).correlation == 0.f);
+}
+
+TEST_CASE("AudioTraits::HasDelayOf Tests")
+{
+    constexpr int signalLength = 24000;
+    std::vector<float> noise1 = SignalGenerator::createWhiteNoise(signalLength, 0.f, 11 /*seed*/);
+    std::vector<float> noise2 = SignalGenerator::createWhiteNoise(signalLength, 0.f, 12 /*seed*/);
+    std::vector<std::vector<float>> referenceData { noise1, noise2 };
+    SignalAdapterStdVecVec reference(referenceData);
+    
+    int delay = GENERATE(0, 5, 2500);
+    std::vector<std::vector<float>> signalData { delayed(noise1, delay), delayed(noise2, delay + 100) };
+    SignalAdapterStdVecVec signal(signalData);
+    
+    REQUIRE(check<HasDelayOf>(signal, {1}, reference, delay));
+    REQUIRE(check<HasDelayOf>(signal, {2}, reference, delay + 100));
+    REQUIRE_FALSE(check<HasDelayOf>(signal, {}, reference, delay));
+    REQUIRE_FALSE(check<HasDelayOf>(signal, {1}, reference, delay + 1));
+    REQUIRE_FALSE(check<HasDelayOf>(signal, {1}, reference, delay - 1));
+    REQUIRE(check<HasDelayOf>(signal, {1}, reference, delay + 1, 1));
+    REQUIRE(check<HasDelayOf>(signal, {}, reference, delay + 50, 50)); // both channels within tolerance
+    REQUIRE_FALSE(check<HasDelayOf>(signal, {}, reference, delay + 50, 49));
+    REQUIRE(check<HasDelayOf>(signal, {1}, reference, delay + 2000, 2000)); // large tolerance
+    REQUIRE_FALSE(check<HasDelayOf>(signal, {1}, reference, delay + 2001, 2000));
+    
+    // negative delay: reference lags the signal
+    REQUIRE(check<HasDelayOf>(reference, {1}, signal, -delay));
+    
+    SECTION("Scaled and noisy signals still have the delay") {
+        std::vector<float> disturbance = SignalGenerator::createWhiteNoise(signalLength, -10.f, 13 /*seed*/);
+        for (int i = 0; i < signalLength; ++i) {
+            signalData[0][i] = 0.5f * signalData[0][i] + disturbance[i];
+        }
+        REQUIRE(check<HasDelayOf>(signal, {1}, reference, delay));
+        REQUIRE_FALSE(check<HasDelayOf>(signal, {1}, reference, delay, 0, 0.99f)); // not 'identical enough'
+    }
+    
+    SECTION("Uncorrelated & silent signals") {
+        std::vector<std::vector<float>> swappedData { noise2, noise1 };
+        SignalAdapterStdVecVec swapped(swappedData);
+        REQUIRE_FALSE(check<HasDelayOf>(swapped, {}, reference, 0, 1000));
+        
+        std::vector<std::vector<float>> silenceData(2, std::vector<float>(signalLength, 0.f));
+        SignalAdapterStdVecVec silence(silenceData);
+        REQUIRE_FALSE(check<HasDelayOf>(silence, {}, reference, 0, 1000));
+    }
+    
+    SECTION("Invalid parameters") {
+        REQUIRE_THROWS(check<HasDelayOf>(signal, {}, reference, delay, -1));
+        REQUIRE_THROWS(check<HasDelayOf>(signal, {}, reference, delay, 0, 0.f));
+        REQUIRE_THROWS(check<HasDelayOf>(signal, {}, reference, delay, 0, 1.1f));
+    }
+}
@@ -0,0 +1,258 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//  
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#include "TestCommon.hpp"
+#include "SignalGenerator.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#ifdef SLB_AMALGATED_HEADER
+    #include "AudioTraits.hpp"
+#else
+    #include "AudioTraits.hpp"
+    #include "Execution.hpp"
+#endif
+
+using namespace slb;
+using namespace slb::AudioTraits;
+using namespace TestCommon;
+
+namespace
+{
+std::atomic<int> numEvaluatedChannels { 0 };
+
+/** Separable trait: true if the channel number is not in the list of failing channels. Counts the evaluations. */
+struct IsNotFailingChannel
+{
+    using ChannelSeparable = std::true_type;
+    
+    static bool eval(const ISignal& /*signal*/, const std::set<int>& selectedChannels, const std::set<int>& failingChannels)
+    {
+        for (int chNumber : selectedChannels) {
+            numEvaluatedChannels++;
+            if (failingChannels.count(chNumber) > 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/** Separable trait that fails with an assertion on the given channel */
+struct ThrowsOnChannel
+{
+    using ChannelSeparable = std::true_type;
+    
+    static bool eval(const ISignal& /*signal*/, const std::set<int>& selectedChannels, int throwingChannel)
+    {
+        for (int chNumber : selectedChannels) {
+            SLB_ASSERT(chNumber != throwingChannel, "channel throws");
+        }
+        return true;
+    }
+};
+
+/** Separable trait that fails on one channel and throws on another one */
+struct FailsAndThrowsOnChannels
+{
+    using ChannelSeparable = std::true_type;
+    
+    static bool eval(const ISignal& /*signal*/, const std::set<int>& selectedChannels, int failingChannel, int throwingChannel)
+    {
+        for (int chNumber : selectedChannels) {
+            SLB_ASSERT(chNumber != throwingChannel, "channel throws");
+            if (chNumber == failingChannel) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/** Non-separable trait: receives the entire selection at once */
+struct HasNumberOfSelectedChannels
+{
+    static bool eval(const ISignal& /*signal*/, const std::set<int>& selectedChannels, int expectedNumChannels)
+    {
+        return static_cast<int>(selectedChannels.size()) == expectedNumChannels;
+    }
+};
+/** A std::thread that fails to start once a given number of threads has been started, like on thread exhaustion */
+struct LimitedThread : std::thread
+{
+    static std::atomic<int> numStartsLeft;
+    
+    template<typename Fn>
+    explicit LimitedThread(const Fn& fn) : std::thread(start(fn)) {}
+    
+private:
+    template<typename Fn>
+    static const Fn& start(const Fn& fn)
+    {
+        if (numStartsLeft.fetch_sub(1) <= 0) {
+            throw std::system_error(std::make_error_code(std::errc::resource_unavailable_try_again));
+        }
+        return fn;
+    }
+};
+std::atomic<int> LimitedThread::numStartsLeft { 0 };
+} // namespace
+
+TEST_CASE("Execution Policies: Worker Threads")
+{
+    constexpr int numItems = 128;
+    std::atomic<bool> abortFlag { false };
+    std::atomic<int> nextItem { 0 };
+    std::atomic<int> numProcessedItems { 0 };
+    auto worker = [&]()
+    {
+        while (!abortFlag && nextItem.fetch_add(1) < numItems) {
+            numProcessedItems++;
+        }
+    };
+    
+    SECTION("Threads that cannot be started leave their work to the running ones") {
+        const int numStartableThreads = GENERATE(0, 1, 3);
+        LimitedThread::numStartsLeft = numStartableThreads;
+        Execution::runOnThreads<LimitedThread>(8, abortFlag, worker);
+        REQUIRE(numProcessedItems == numItems);
+        REQUIRE_FALSE(abortFlag);
+    }
+    
+    SECTION("Threads are stopped and joined if the calling thread throws") {
+        const std::thread::id callingThread = std::this_thread::get_id();
+        std::atomic<int> numFinishedThreads { 0 };
+        auto throwingWorker = [&]()
+        {
+            if (std::this_thread::get_id() == callingThread) {
+                throw std::runtime_error("calling thread throws");
+            }
+            while (!abortFlag) {
+                std::this_thread::yield();
+            }
+            numFinishedThreads++;
+        };
+        REQUIRE_THROWS_AS(Execution::runOnThreads(4, abortFlag, throwingWorker), std::runtime_error);
+        REQUIRE(abortFlag);
+        REQUIRE(numFinishedThreads == 3); // all threads have been joined when the exception leaves runOnThreads
+    }
+}
+
+TEST_CASE("Execution Policies: Channel Separability")
+{
+    static_assert(IsChannelSeparable<HasSignalOnAllChannels>::value, "");
+    static_assert(IsChannelSeparable<IsDelayedVersionOf>::value, "");
+    static_assert(IsChannelSeparable<HaveIdenticalChannels>::value, "");
+    static_assert(IsChannelSeparable<HasSignalInAllBands>::value, "");
+    static_assert(IsChannelSeparable<HasSignalOnlyInBands>::value, "");
+    static_assert(IsChannelSeparable<HasDelayOf>::value, "");
+    static_assert(!IsChannelSeparable<HasIdenticalChannels>::value, "compares channels with each other");
+    static_assert(!IsChannelSeparable<HasNumberOfSelectedChannels>::value, "");
+    
+    std::vector<std::vector<float>> buffer(16, std::vector<float>(8, 0.f));
+    SignalAdapterStdVecVec signal(buffer);
+    
+    // non-separable traits are evaluated sequentially, with the entire selection
+    REQUIRE(check<HasNumberOfSelectedChannels>(exec::parallel, signal, {}, 16));
+    REQUIRE(check<HasNumberOfSelectedChannels>(exec::parallel_policy(4), signal, {{2, 5}}, 4));
+    REQUIRE(check<HasNumberOfSelectedChannels>(exec::sequenced, signal, {1, 3}, 2));
+}
+
+TEST_CASE("Execution Policies: Parallel Evaluation")
+{
+    constexpr int numChannels = 128;
+    std::vector<std::vector<float>> buffer(numChannels, std::vector<float>(8, 0.f));
+    SignalAdapterStdVecVec signal(buffer);
+    
+    int numThreads = GENERATE(0, 1, 2, 3, 8, 200);
+    exec::parallel_policy policy(numThreads);
+    REQUIRE(policy.getNumThreads() >= 1);
+    
+    SECTION("All channels are evaluated if none fail") {
+        numEvaluatedChannels = 0;
+        REQUIRE(check<IsNotFailingChannel>(policy, signal, {}, std::set<int>{}));
+        REQUIRE(numEvaluatedChannels == numChannels);
+        
+        numEvaluatedChannels = 0;
+        REQUIRE(check<IsNotFailingChannel>(policy, signal, {1, {10, 19}}, std::set<int>{2, 3}));
+        REQUIRE(numEvaluatedChannels == 11);
+    }
+    
+    SECTION("Result is the same for any failing channel") {
+        for (int failingChannel : {1, 2, 64, 127, 128}) {
+            REQUIRE_FALSE(check<IsNotFailingChannel>(policy, signal, {}, std::set<int>{failingChannel}));
+            REQUIRE(check<IsNotFailingChannel>(policy, signal, {}, std::set<int>{failingChannel}) ==
+                    check<IsNotFailingChannel>(signal, {}, std::set<int>{failingChannel}));
+        }
+    }
+    
+    SECTION("Short-circuits when channels fail") {
+        std::set<int> allChannels;
+        for (int ch = 1; ch <= numChannels; ++ch) {
+            allChannels.insert(ch);
+        }
+        numEvaluatedChannels = 0;
+        REQUIRE_FALSE(check<IsNotFailingChannel>(policy, signal, {}, allChannels));
+        REQUIRE(numEvaluatedChannels <= policy.getNumThreads()); // every thread stops after its first failure
+    }
+    
+    SECTION("Exceptions are propagated") {
+        REQUIRE_THROWS(check<ThrowsOnChannel>(policy, signal, {}, 77));
+        REQUIRE_THROWS(check<ThrowsOnChannel>(policy, signal, {}, 1));
+        REQUIRE_NOTHROW(check<ThrowsOnChannel>(policy, signal, {{1, 76}}, 77));
+    }
+    
+    SECTION("The lowest channel that does not pass decides, like in the sequential evaluation") {
+        for (int i = 0; i < 20; ++i) { // independent of the scheduling of the threads
+            REQUIRE_FALSE(check<FailsAndThrowsOnChannels>(policy, signal, {}, 5, 6));
+            REQUIRE_FALSE(check<FailsAndThrowsOnChannels>(policy, signal, {}, 1, 128));
+            REQUIRE_THROWS(check<FailsAndThrowsOnChannels>(policy, signal, {}, 6, 5));
+            REQUIRE_THROWS(check<FailsAndThrowsOnChannels>(policy, signal, {}, 128, 1));
+        }
+        REQUIRE_FALSE(check<FailsAndThrowsOnChannels>(signal, {}, 5, 6));
+        REQUIRE_THROWS(check<FailsAndThrowsOnChannels>(signal, {}, 6, 5));
+    }
+}
+
+TEST_CASE("Execution Policies: Parallel Evaluation of Audio Traits")
+{
+    constexpr float sampleRate = 48e3f;
+    constexpr int numChannels = 32;
+    constexpr int signalLength = 8192;
+    
+    std::vector<std::vector<float>> buffer;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        buffer.push_back(SignalGenerator::createSine<float>(1000.f + 100.f * static_cast<float>(ch), sampleRate, signalLength));
+    }
+    SignalAdapterStdVecVec signal(buffer);
+    AnalyzedSignal analyzedSignal(signal);
+    std::vector<std::vector<float>> silenceBuffer(numChannels, std::vector<float>(signalLength, 0.f));
+    SignalAdapterStdVecVec silence(silenceBuffer);
+    
+    const exec::parallel_policy policy(4);
+    REQUIRE(check<HasSignalOnAllChannels>(policy, signal, {}) == check<HasSignalOnAllChannels>(signal, {}));
+    REQUIRE(check<HasSignalOnAllChannels>(policy, signal, {}, 0.f) == check<HasSignalOnAllChannels>(signal, {}, 0.f));
+    REQUIRE_FALSE(check<HasSignalOnAllChannels>(policy, silence, {}));
+    REQUIRE(check<HaveIdenticalChannels>(policy, signal, {}, signal));
+    REQUIRE_FALSE(check<HaveIdenticalChannels>(policy, signal, {}, silence));
+    REQUIRE(check<IsDelayedVersionOf>(policy, signal, {}, signal, 0));
+    REQUIRE(check<HasDelayOf>(policy, signal, {}, signal, 0));
+    
+    for (const ISignal* s : {static_cast<const ISignal*>(&signal), static_cast<const ISignal*>(&analyzedSignal)}) {
+        REQUIRE(check<HasSignalOnlyInBands>(policy, *s, {}, Freqs{{900, 4200}}, sampleRate));
+        REQUIRE_FALSE(check<HasSignalOnlyInBands>(policy, *s, {}, Freqs{{900, 4000}}, sampleRate));
+        REQUIRE(check<HasSignalOnlyBelow>(policy, *s, {{1, 10}}, 2000.f, sampleRate));
+        REQUIRE(check<HasSignalInAllBands>(policy, *s, {1}, Freqs{1000}, sampleRate));
+        REQUIRE_FALSE(check<HasSignalInAllBands>(policy, *s, {}, Freqs{1000}, sampleRate));
+    }
+    REQUIRE(analyzedSignal.getSpectrumCache().getNumEntries() <= numChannels);
+}
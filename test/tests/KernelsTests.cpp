@@ -0,0 +1,218 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//  
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#include "TestCommon.hpp"
+#include "SignalGenerator.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#if (defined(__unix__) || defined(__APPLE__)) && INTPTR_MAX > INT32_MAX
+    #include <sys/mman.h>
+    #define SLB_TEST_SPARSE_BUFFERS
+#endif
+
+#ifdef SLB_AMALGATED_HEADER
+    #include "AudioTraits.hpp"
+#else
+    #include "Kernels.hpp"
+    #include "SampleTypes.hpp"
+#endif
+
+using namespace slb;
+using namespace slb::AudioTraits;
+using namespace TestCommon;
+
+TEST_CASE("Kernels::containsAbsValueAtLeast Tests")
+{
+    // lengths around the vector width and block sizes of all instruction sets
+    int length = GENERATE(0, 1, 3, 4, 7, 8, 9, 31, 32, 33, 63, 64, 65, 100, 1000);
+    std::vector<float> noise = SignalGenerator::createWhiteNoise(length, -20.f, length /*seed*/);
+    
+    SECTION("Vectorized and scalar versions agree") {
+        for (float threshold : {0.f, 0.01f, 0.05f, 0.09f, 0.1f, 0.2f}) {
+            const bool expected = std::any_of(noise.begin(), noise.end(), [threshold](float s) { return std::abs(s) >= threshold; });
+            REQUIRE(Kernels::Scalar::containsAbsValueAtLeast(noise.data(), length, 1, threshold) == expected);
+            REQUIRE(Kernels::containsAbsValueAtLeast(noise.data(), length, threshold) == expected);
+            REQUIRE(Kernels::containsAbsValueAtLeast(ChannelView(noise.data(), length), threshold) == expected);
+        }
+    }
+    
+    SECTION("Single peak at every position, positive and negative") {
+        for (int position = 0; position < length; ++position) {
+            for (float peak : {0.5f, -0.5f}) {
+                std::vector<float> data(length, 0.1f);
+                data[position] = peak;
+                REQUIRE(Kernels::containsAbsValueAtLeast(data.data(), length, 0.5f));
+                REQUIRE_FALSE(Kernels::containsAbsValueAtLeast(data.data(), length, 0.50001f));
+            }
+        }
+    }
+    
+    SECTION("Strided data") {
+        std::vector<float> interleaved(2 * length, 0.f);
+        for (int i = 0; i < length; ++i) {
+            interleaved[2*i+1] = noise[i];
+        }
+        ChannelView silentChannel(interleaved.data(), length, 2);
+        ChannelView noiseChannel(interleaved.data() + 1, length, 2);
+        REQUIRE_FALSE(Kernels::containsAbsValueAtLeast(silentChannel, 1e-9f));
+        REQUIRE(Kernels::containsAbsValueAtLeast(noiseChannel, 1e-9f) == (length > 0));
+        
+        for (float threshold : {0.f, 0.01f, 0.05f, 0.09f, 0.1f, 0.2f}) {
+            const bool expected = std::any_of(noise.begin(), noise.end(), [threshold](float s) { return std::abs(s) >= threshold; });
+            REQUIRE(Kernels::Strided::containsAbsValueAtLeast(interleaved.data() + 1, length, 2, threshold) == expected);
+            REQUIRE(Kernels::containsAbsValueAtLeast(noiseChannel, threshold) == expected);
+        }
+        for (int position = 0; position < length; ++position) {
+            std::vector<float> data(3 * length, 0.1f);
+            data[3 * position + 2] = -0.5f;
+            REQUIRE(Kernels::containsAbsValueAtLeast(ChannelView(data.data() + 2, length, 3), 0.5f));
+            REQUIRE_FALSE(Kernels::containsAbsValueAtLeast(ChannelView(data.data() + 1, length, 3), 0.5f));
+        }
+    }
+}
+
+TEST_CASE("Kernels::areMagnitudesWithinRatio Tests")
+{
+    int length = GENERATE(0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 32, 33, 100, 1000);
+    std::vector<float> a = SignalGenerator::createWhiteNoise(length, 0.f, length /*seed*/);
+    
+    // Reference: comparison of the level difference in dB
+    auto levelDifferenceWithin = [](float v1, float v2, float tolerance_dB)
+    {
+        return std::abs(Utils::linear2Db(std::abs(v1)) - Utils::linear2Db(std::abs(v2))) <= tolerance_dB;
+    };
+    
+    SECTION("Agrees with level difference in dB") {
+        std::vector<float> gainsdB = SignalGenerator::createWhiteNoise(length, 20.f, 2*length /*seed*/); // [-10, 10] dB
+        std::vector<float> b(length);
+        for (int i = 0; i < length; ++i) {
+            b[i] = -a[i] * Utils::dB2Linear(gainsdB[i]); // sign must not matter
+        }
+        for (float tolerance_dB : {0.f, 0.5f, 1.f, 3.f, 6.f, 9.f, 11.f}) {
+            const float ratio = Utils::dB2Linear(tolerance_dB);
+            // exclude pairs whose level difference is just at the tolerance (rounding)
+            bool expected = true;
+            bool isAmbiguous = false;
+            for (int i = 0; i < length; ++i) {
+                expected &= levelDifferenceWithin(a[i], b[i], tolerance_dB);
+                isAmbiguous |= (std::abs(std::abs(gainsdB[i]) - tolerance_dB) < 1e-3f);
+            }
+            if (isAmbiguous) {
+                continue;
+            }
+            REQUIRE(Kernels::Scalar::areMagnitudesWithinRatio(a.data(), 1, b.data(), 1, length, ratio) == expected);
+            REQUIRE(Kernels::areMagnitudesWithinRatio(a.data(), b.data(), length, ratio) == expected);
+            REQUIRE(Kernels::areMagnitudesWithinRatio(ChannelView(a.data(), length), ChannelView(b.data(), length), ratio) == expected);
+        }
+    }
+    
+    SECTION("Single deviation at every position") {
+        for (int position = 0; position < length; ++position) {
+            std::vector<float> b = a;
+            b[position] *= Utils::dB2Linear(-1.f);
+            REQUIRE(Kernels::areMagnitudesWithinRatio(a.data(), b.data(), length, Utils::dB2Linear(1.001f)));
+            REQUIRE_FALSE(Kernels::areMagnitudesWithinRatio(a.data(), b.data(), length, Utils::dB2Linear(0.999f)));
+            b[position] = 0.f; // silence never matches a non-zero sample
+            REQUIRE_FALSE(Kernels::areMagnitudesWithinRatio(a.data(), b.data(), length, Utils::dB2Linear(90.f)));
+            // NaN never matches -- neither a non-zero sample, nor silence, nor NaN
+            b[position] = std::numeric_limits<float>::quiet_NaN();
+            REQUIRE_FALSE(Kernels::Scalar::areMagnitudesWithinRatio(a.data(), 1, b.data(), 1, length, Utils::dB2Linear(90.f)));
+            REQUIRE_FALSE(Kernels::Strided::areMagnitudesWithinRatio(a.data(), 1, b.data(), 1, length, Utils::dB2Linear(90.f)));
+            REQUIRE_FALSE(Kernels::areMagnitudesWithinRatio(a.data(), b.data(), length, Utils::dB2Linear(90.f)));
+            REQUIRE_FALSE(Kernels::areMagnitudesWithinRatio(b.data(), a.data(), length, Utils::dB2Linear(90.f)));
+            REQUIRE_FALSE(Kernels::areMagnitudesWithinRatio(b.data(), b.data(), length, Utils::dB2Linear(90.f)));
+            std::vector<float> zeros(length, 0.f);
+            REQUIRE_FALSE(Kernels::areMagnitudesWithinRatio(zeros.data(), b.data(), length, Utils::dB2Linear(90.f)));
+        }
+    }
+    
+    SECTION("Zeros & strided data") {
+        std::vector<float> zeros(length, 0.f);
+        REQUIRE(Kernels::areMagnitudesWithinRatio(zeros.data(), zeros.data(), length, 1.f));
+        
+        std::vector<float> interleaved(2 * length);
+        for (int i = 0; i < length; ++i) {
+            interleaved[2*i] = a[i];
+            interleaved[2*i+1] = -a[i];
+        }
+        REQUIRE(Kernels::areMagnitudesWithinRatio(ChannelView(interleaved.data(), length, 2), ChannelView(interleaved.data() + 1, length, 2), 1.f));
+        REQUIRE(Kernels::areMagnitudesWithinRatio(ChannelView(interleaved.data(), length, 2), ChannelView(a.data(), length), 1.f));
+        if (length > 0) {
+            REQUIRE_THROWS(Kernels::areMagnitudesWithinRatio(ChannelView(a.data(), length), ChannelView(a.data(), 0), 1.f));
+        }
+        
+        for (int position = 0; position < length; ++position) {
+            std::vector<float> deviating = interleaved;
+            deviating[2 * position + 1] *= Utils::dB2Linear(-1.f);
+            const ChannelView first(deviating.data(), length, 2);
+            const ChannelView second(deviating.data() + 1, length, 2);
+            REQUIRE(Kernels::Strided::areMagnitudesWithinRatio(first.data(), 2, second.data(), 2, length, Utils::dB2Linear(1.001f)));
+            REQUIRE_FALSE(Kernels::Strided::areMagnitudesWithinRatio(first.data(), 2, second.data(), 2, length, Utils::dB2Linear(0.999f)));
+            REQUIRE_FALSE(Kernels::areMagnitudesWithinRatio(second, ChannelView(a.data(), length), Utils::dB2Linear(0.999f)));
+        }
+    }
+}
+
+TEST_CASE("Kernels::multiply Tests")
+{
+    int length = GENERATE(0, 1, 3, 4, 7, 8, 9, 31, 32, 33, 100);
+    std::vector<float> samples = SignalGenerator::createWhiteNoise(length, 0.f, 1 /*seed*/);
+    std::vector<float> factors = SignalGenerator::createWhiteNoise(length, 0.f, 2 /*seed*/);
+    
+    std::vector<float> expected = samples;
+    Kernels::Scalar::multiply(expected.data(), factors.data(), length);
+    for (int i = 0; i < length; ++i) {
+        REQUIRE(expected[i] == samples[i] * factors[i]);
+    }
+    
+    std::vector<float> result(length);
+    Kernels::multiply(samples.data(), factors.data(), result.data(), length);
+    REQUIRE(result == expected);
+    
+    Kernels::multiply(samples.data(), factors.data(), length);
+    REQUIRE(samples == expected);
+}
+
+TEST_CASE("Kernels: Strided Offsets Beyond the int Range")
+{
+    // 128 interleaved channels of 2^24 + 1 samples (~5.8 min at 48kHz): the last sample is 2^31 elements from the first
+    constexpr int numChannels = 128;
+    constexpr int numSamples = (1 << 24) + 1;
+    static_assert(Utils::stridedOffset(numSamples - 1, numChannels) == (std::ptrdiff_t{1} << 31), "");
+    REQUIRE(Utils::stridedOffset(INT_MAX, 2) == 2 * static_cast<std::ptrdiff_t>(INT_MAX));
+    REQUIRE(Utils::stridedOffset(0, numChannels) == 0);
+    
+#ifdef SLB_TEST_SPARSE_BUFFERS
+    // only the pages that are accessed are backed by memory
+    const size_t bufferLength = static_cast<size_t>(numSamples) * numChannels;
+    void* mapping = ::mmap(nullptr, bufferLength * sizeof(float), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mapping == MAP_FAILED) {
+        WARN("Could not reserve a sparse buffer, skipping the strided access");
+        return;
+    }
+    float* buffer = static_cast<float*>(mapping);
+    buffer[bufferLength - 1] = 0.5f; // last sample of the last channel
+    
+    const ChannelView lastChannel(buffer + numChannels - 1, numSamples, numChannels);
+    REQUIRE(lastChannel[numSamples - 1] == 0.5f);
+    REQUIRE(lastChannel.subView(numSamples - 10, 10)[9] == 0.5f);
+    REQUIRE(Kernels::containsAbsValueAtLeast(lastChannel, 0.5f)); // scans the entire channel
+    REQUIRE_FALSE(Kernels::areMagnitudesWithinRatio(lastChannel, ChannelView(buffer, numSamples, numChannels), 2.f));
+    
+    std::vector<float> converted(10);
+    convertToFloat(lastChannel.data() + Utils::stridedOffset(numSamples - 10, numChannels), numChannels, 10, converted.data());
+    REQUIRE(converted.back() == 0.5f);
+    
+    ::munmap(mapping, bufferLength * sizeof(float));
+#endif
+}
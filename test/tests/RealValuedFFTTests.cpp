@@ -12,6 +12,8 @@
 #include <numeric>
 #include <iostream>
 
+#include "MemorySentinel.hpp"
+
 #ifdef SLB_AMALGATED_HEADER
     #include "AudioTraits.hpp"
 #else
@@ -179,3 +181,181 @@ TEST_CASE("RealValuedFFT Tests")
         }
     }
 }
+
+TEST_CASE("RealValuedFFT Pointer API & MemorySentinel Tests")
+{
+    int fftLength = GENERATE(16, 512, 4096, 16384);
+    
+    RealValuedFFT fft(fftLength);
+    REQUIRE(fft.getLength() == fftLength);
+    REQUIRE(fft.getNumBins() == fftLength/2 + 1);
+    
+    std::vector<float> noise = SignalGenerator::createWhiteNoise(fftLength);
+    std::vector<std::complex<float>> bins(fft.getNumBins());
+    std::vector<float> restoredNoise(fftLength);
+    
+    MemorySentinel& sentinel = MemorySentinel::getInstance();
+    sentinel.setTransgressionBehaviour(MemorySentinel::TransgressionBehaviour::SILENT);
+    sentinel.clearTransgressions();
+    sentinel.setArmed(true);
+    {
+        fft.performForward(noise.data(), bins.data());
+        fft.performInverse(bins.data(), restoredNoise.data());
+    }
+    sentinel.setArmed(false);
+    REQUIRE_FALSE(sentinel.hasTransgressionOccured());
+    
+    // Identical results to the std::vector API
+    REQUIRE(bins == fft.performForward(noise));
+    REQUIRE(restoredNoise == fft.performInverse(bins));
+    
+    // input is not modified
+    REQUIRE(noise == SignalGenerator::createWhiteNoise(fftLength));
+    REQUIRE(std::equal(noise.begin(), noise.end(), restoredNoise.begin(), [](auto& a, auto& b)
+    {
+        return std::abs(a-b) < 1e-6f;
+    }));
+}
+
+TEST_CASE("RealValuedFFT Plan Registry Tests")
+{
+    int fftLength = GENERATE(16, 500, 4096, 16384);
+    const int N = static_cast<int>(Utils::nextPowerOfTwo(static_cast<uint32_t>(fftLength)));
+    
+    std::shared_ptr<const FFTPlan> plan = FFTPlan::get(fftLength);
+    REQUIRE(plan->getLength() == N);
+    REQUIRE(FFTPlan::get(fftLength) == plan); // built only once
+    REQUIRE(FFTPlan::get(N) == plan);
+    REQUIRE(FFTPlan::get(N == 16 ? 32 : 16) != plan);
+    
+    // executors share the plan, but have their own work buffers
+    RealValuedFFT fftA(fftLength);
+    RealValuedFFT fftB(plan);
+    REQUIRE(fftA.getPlan() == plan);
+    REQUIRE(fftB.getPlan() == plan);
+    REQUIRE(fftB.getLength() == N);
+    
+    std::vector<float> noiseA = SignalGenerator::createWhiteNoise(N, 0.f, 1 /*seed*/);
+    std::vector<float> noiseB = SignalGenerator::createWhiteNoise(N, 0.f, 2 /*seed*/);
+    std::vector<std::complex<float>> binsA = fftA.performForward(noiseA);
+    std::vector<std::complex<float>> binsB = fftB.performForward(noiseB);
+    REQUIRE(binsA == RealValuedFFT(N).performForward(noiseA));
+    REQUIRE(binsB == RealValuedFFT(N).performForward(noiseB));
+    REQUIRE(fftB.performInverse(binsA) == fftA.performInverse(binsA));
+    
+    REQUIRE_THROWS(FFTPlan::get(8));
+    REQUIRE_THROWS(FFTPlan::get((1 << 20) + 1));
+}
+
+TEST_CASE("RealValuedFFT Vectorized vs. Reference Implementation")
+{
+    int fftLength = GENERATE(16, 32, 64, 128, 512, 2048, 4096, 16384);
+    
+    RealValuedFFT reference(fftLength, FFTImplementation::Reference);
+    RealValuedFFT vectorized(fftLength, FFTImplementation::Vectorized);
+    REQUIRE(vectorized.getImplementation() == FFTImplementation::Vectorized);
+    REQUIRE(vectorized.getPlan() == reference.getPlan());
+    
+    std::vector<float> noise = SignalGenerator::createWhiteNoise(fftLength, 0.f, 5 /*seed*/);
+    std::vector<std::complex<float>> referenceBins = reference.performForward(noise);
+    std::vector<std::complex<float>> vectorizedBins = vectorized.performForward(noise);
+    
+    // equal within rounding errors (relative to the full-scale bin value)
+    const float tolerance = 1e-6f * static_cast<float>(fftLength);
+    REQUIRE(std::equal(referenceBins.begin(), referenceBins.end(), vectorizedBins.begin(), [tolerance](auto& a, auto& b)
+    {
+        return std::abs(a-b) < tolerance;
+    }));
+    
+    // against a DFT calculated in double precision
+    if (fftLength <= 512) {
+        for (int k = 0; k < fftLength/2 + 1; ++k) {
+            std::complex<double> expected = 0;
+            for (int n = 0; n < fftLength; ++n) {
+                expected += static_cast<double>(noise[n]) * std::polar(1.0, -2 * M_PI * k * n / fftLength);
+            }
+            REQUIRE(std::abs(std::complex<double>(vectorizedBins[k]) - expected) < tolerance);
+        }
+    }
+    
+    std::vector<float> referenceRestored = reference.performInverse(referenceBins);
+    std::vector<float> vectorizedRestored = vectorized.performInverse(referenceBins);
+    REQUIRE(std::equal(referenceRestored.begin(), referenceRestored.end(), vectorizedRestored.begin(), [](auto& a, auto& b)
+    {
+        return std::abs(a-b) < 1e-6f;
+    }));
+    
+    // no allocations
+    std::vector<float> restoredNoise(fftLength);
+    MemorySentinel& sentinel = MemorySentinel::getInstance();
+    sentinel.setTransgressionBehaviour(MemorySentinel::TransgressionBehaviour::SILENT);
+    sentinel.clearTransgressions();
+    sentinel.setArmed(true);
+    {
+        vectorized.performForward(noise.data(), vectorizedBins.data());
+        vectorized.performInverse(vectorizedBins.data(), restoredNoise.data());
+    }
+    sentinel.setArmed(false);
+    REQUIRE_FALSE(sentinel.hasTransgressionOccured());
+    REQUIRE(std::equal(noise.begin(), noise.end(), restoredNoise.begin(), [](auto& a, auto& b)
+    {
+        return std::abs(a-b) < 1e-6f;
+    }));
+}
+
+TEST_CASE("RealValuedFFT Long Transforms")
+{
+    int fftLength = GENERATE(32768, 65536, 1 << 20);
+    
+    std::shared_ptr<const FFTPlan> plan = FFTPlan::get(fftLength);
+    REQUIRE(plan->getLength() == fftLength);
+    REQUIRE_FALSE(plan->supportsReferenceImplementation());
+    REQUIRE(FFTPlan::get(16384)->supportsReferenceImplementation());
+    
+    // beyond the range of the reference kernel, the vectorized one is used
+    RealValuedFFT fft(fftLength, FFTImplementation::Reference);
+    REQUIRE(fft.getImplementation() == FFTImplementation::Vectorized);
+    REQUIRE(fft.getNumBins() == fftLength/2 + 1);
+    
+    SECTION("Sub-Hz resolution") {
+        // at 192kHz, the bins of a 1M-point FFT are 0.18 Hz apart: a sine exactly on bin k has all energy in that bin
+        constexpr float sampleRate = 192e3f;
+        const int bin = fftLength / 64 + 1;
+        const float frequency = static_cast<float>(bin) * sampleRate / static_cast<float>(fftLength);
+        std::vector<float> sine = SignalGenerator::createSine<float>(frequency, sampleRate, fftLength);
+        std::vector<float> magnitude = calculateNormalizedMagnitude(fft.performForward(sine));
+        REQUIRE(std::distance(magnitude.begin(), std::max_element(magnitude.begin(), magnitude.end())) == bin);
+        REQUIRE(magnitude[bin - 1] < 1e-2f);
+        REQUIRE(magnitude[bin + 1] < 1e-2f);
+    }
+    
+    SECTION("Against the DFT & chain of FFT and IFFT") {
+        std::vector<float> noise = SignalGenerator::createWhiteNoise(fftLength, 0.f, 9 /*seed*/);
+        std::vector<std::complex<float>> bins = fft.performForward(noise);
+        for (int k : {0, 1, 1000, fftLength/4 + 3, fftLength/2}) {
+            std::complex<double> expected = 0;
+            for (int n = 0; n < fftLength; ++n) {
+                expected += static_cast<double>(noise[n]) * std::polar(1.0, -2 * M_PI * (static_cast<double>(k) * n / fftLength));
+            }
+            REQUIRE(std::abs(std::complex<double>(bins[k]) - expected) < 1e-5 * fftLength);
+        }
+        
+        std::vector<float> restoredNoise = fft.performInverse(bins);
+        REQUIRE(std::equal(noise.begin(), noise.end(), restoredNoise.begin(), [](auto& a, auto& b)
+        {
+            return std::abs(a-b) < 1e-5f;
+        }));
+    }
+}
+
+TEST_CASE("RealValuedFFT Implementations Benchmark", "[!benchmark]")
+{
+    constexpr int fftLength = 4096;
+    RealValuedFFT reference(fftLength, FFTImplementation::Reference);
+    RealValuedFFT vectorized(fftLength, FFTImplementation::Vectorized);
+    std::vector<float> noise = SignalGenerator::createWhiteNoise(fftLength);
+    std::vector<std::complex<float>> bins(reference.getNumBins());
+    
+    BENCHMARK("Reference") { reference.performForward(noise.data(), bins.data()); return bins[1]; };
+    BENCHMARK("Vectorized") { vectorized.performForward(noise.data(), bins.data()); return bins[1]; };
+}
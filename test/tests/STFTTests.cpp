@@ -0,0 +1,222 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#include "TestCommon.hpp"
+#include "SignalGenerator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef SLB_AMALGATED_HEADER
+    #include "AudioTraits.hpp"
+#else
+    #include "AudioTraits.hpp"
+#endif
+
+using namespace slb;
+using namespace slb::AudioTraits;
+using namespace TestCommon;
+
+namespace
+{
+using FrameRange = std::pair<std::int64_t, std::int64_t>;
+
+/** 1s of a 1000Hz sine, followed by 1s of a 8000Hz sine */
+std::vector<float> createFrequencyStep(float sampleRate)
+{
+    const int length = static_cast<int>(sampleRate);
+    std::vector<float> signal = SignalGenerator::createSine<float>(1000, sampleRate, length, -6.f);
+    const std::vector<float> secondPart = SignalGenerator::createSine<float>(8000, sampleRate, length, -6.f);
+    signal.insert(signal.end(), secondPart.begin(), secondPart.end());
+    return signal;
+}
+
+int findPeakBin(const std::vector<float>& binValues)
+{
+    return static_cast<int>(std::distance(binValues.begin(), std::max_element(binValues.begin(), binValues.end())));
+}
+} // namespace
+
+TEST_CASE("ShortTimeFourierTransform Tests")
+{
+    constexpr float sampleRate = 48e3f;
+    const std::vector<float> signal = createFrequencyStep(sampleRate);
+    const ChannelView signalView(signal.data(), static_cast<int>(signal.size()));
+
+    SECTION("Invalid settings") {
+        REQUIRE_THROWS(ShortTimeFourierTransform(1000));
+        REQUIRE_THROWS(ShortTimeFourierTransform(1024, STFTSettings{-1, WindowType::Hann}));
+        REQUIRE_THROWS(ShortTimeFourierTransform(1024, STFTSettings{1025, WindowType::Hann}));
+        REQUIRE_THROWS(TimeRange(-1.f));
+        REQUIRE_THROWS(TimeRange(2.f, 1.f));
+        // a missing time range must not turn the next argument (e.g. the sample rate) into one
+        static_assert(!std::is_convertible<float, TimeRange>::value, "TimeRange has to be constructed explicitly");
+    }
+
+    SECTION("Frames and hop size") {
+        ShortTimeFourierTransform stft;
+        REQUIRE(stft.getFftLength() == 1024);
+        REQUIRE(stft.getHopSize() == 512);
+        REQUIRE(ShortTimeFourierTransform(1024, STFTSettings{256, WindowType::Hann}).getHopSize() == 256);
+
+        std::vector<std::int64_t> frameIndices;
+        stft.process(ChannelView(signal.data(), 3000), [&frameIndices](std::int64_t frameIndex, const std::vector<float>& binValues)
+        {
+            REQUIRE(binValues.size() == 513);
+            frameIndices.push_back(frameIndex);
+            return true;
+        });
+        REQUIRE(frameIndices == std::vector<std::int64_t>{0, 1, 2, 3}); // complete frames only
+        REQUIRE(stft.getNumFrames() == 4);
+
+        // frames whose center lies in the time range
+        REQUIRE(stft.getFramesInTimeRange(TimeRange{0.f}, sampleRate) == FrameRange{0, (std::numeric_limits<std::int64_t>::max() - 1024) / 512});
+        REQUIRE(stft.getFramesInTimeRange(TimeRange{0.f, 1.f}, sampleRate) == FrameRange{0, 92}); // center 92 * 512 + 512 = 47616
+        REQUIRE(stft.getFramesInTimeRange(TimeRange{1.f, 2.f}, sampleRate) == FrameRange{93, 186});
+        // beyond 2^31 samples (~12.4h at 48kHz)
+        REQUIRE(stft.getFramesInTimeRange(TimeRange{50000.f, 50001.f}, sampleRate) == FrameRange{4687499, 4687592});
+        REQUIRE(stft.getFramesInTimeRange(TimeRange{0.f, 0.001f}, sampleRate).second < 0); // shorter than half a frame
+
+        // without an instance
+        REQUIRE(ShortTimeFourierTransform::determineHopSize(1024, STFTSettings{}) == 512);
+        REQUIRE(ShortTimeFourierTransform::determineHopSize(1024, STFTSettings{1024, WindowType::Hann}) == 1024);
+        REQUIRE(ShortTimeFourierTransform::getFramesInTimeRange(TimeRange{1.f, 2.f}, sampleRate, 1024, 512) == FrameRange{93, 186});
+        REQUIRE(ShortTimeFourierTransform::getFramesInTimeRange(TimeRange{0.f, 1.f}, sampleRate, 1024, 1024) == FrameRange{0, 46});
+        REQUIRE_THROWS(ShortTimeFourierTransform::getFramesInTimeRange(TimeRange{0.f}, sampleRate, 1024, 0));
+    }
+
+    SECTION("Spectrogram follows the frequency") {
+        const std::vector<std::vector<float>> frames = FrequencyDomainHelpers::getSpectrogram(signalView);
+        REQUIRE(frames.size() == 186);
+        REQUIRE(findPeakBin(frames[10]) == 21); // 1000 Hz / (48000 Hz / 1024)
+        REQUIRE(findPeakBin(frames[90]) == 21);
+        REQUIRE(findPeakBin(frames[95]) == 171); // 8000 Hz / (48000 Hz / 1024)
+        REQUIRE(findPeakBin(frames[185]) == 171);
+        REQUIRE(frames[10][0] == 0.f);
+        REQUIRE(*std::max_element(frames[10].begin(), frames[10].end()) == 1.f);
+
+        // silent frames stay at 0
+        const std::vector<float> silence = SignalGenerator::createSilence<float>(2048);
+        for (const auto& frame : FrequencyDomainHelpers::getSpectrogram(ChannelView(silence.data(), 2048))) {
+            REQUIRE(*std::max_element(frame.begin(), frame.end()) == 0.f);
+        }
+        // ... like the (averaged) spectrum of a silent channel
+        for (auto scale : {FrequencyDomainHelpers::BinScale::Magnitude, FrequencyDomainHelpers::BinScale::Power}) {
+            const std::vector<float> bins = FrequencyDomainHelpers::getNormalizedBinValues(silence, 1024, WindowType::Hann, scale);
+            REQUIRE(std::all_of(bins.begin(), bins.end(), [](float binValue) { return binValue == 0.f; }));
+        }
+        std::vector<float> noBins;
+        FrequencyDomainHelpers::normalizeBins(noBins);
+        REQUIRE(noBins.empty());
+    }
+
+    SECTION("Result does not depend on the block size") {
+        const STFTSettings settings{300, WindowType::Hann};
+        const std::vector<std::vector<float>> expected = FrequencyDomainHelpers::getSpectrogram(signalView, 512, settings);
+        for (int blockSize : {1, 37, 1000}) {
+            std::vector<std::vector<float>> frames;
+            ShortTimeFourierTransform stft(512, settings);
+            for (int start = 0; start < signalView.size(); start += blockSize) {
+                stft.process(signalView.subView(start, std::min(blockSize, signalView.size() - start)),
+                             [&frames](std::int64_t, const std::vector<float>& binValues) { frames.push_back(binValues); return true; });
+            }
+            REQUIRE(frames == expected);
+        }
+    }
+
+    SECTION("Analysis stops when requested") {
+        ShortTimeFourierTransform stft;
+        int numFrames = 0;
+        REQUIRE_FALSE(stft.process(signalView, [&numFrames](std::int64_t frameIndex, const std::vector<float>&) { ++numFrames; return frameIndex < 4; }));
+        REQUIRE(numFrames == 5);
+    }
+}
+
+TEST_CASE("AudioTraits::FrequencyDomain: time-varying traits")
+{
+    constexpr float sampleRate = 48e3f;
+    const std::vector<float> step = createFrequencyStep(sampleRate);
+    std::vector<std::vector<float>> buffer { step, SignalGenerator::createSine<float>(1000, sampleRate, static_cast<int>(step.size()), -6.f) };
+    SignalAdapterStdVecVec signal(buffer);
+
+    SECTION("HasSignalInBandDuring") {
+        REQUIRE(check<HasSignalInBandDuring>(signal, {}, Freqs{1000}, TimeRange{0.f, 0.9f}, sampleRate));
+        REQUIRE_FALSE(check<HasSignalInBandDuring>(signal, {}, Freqs{1000}, TimeRange{0.f, 1.5f}, sampleRate));
+        REQUIRE(check<HasSignalInBandDuring>(signal, {2}, Freqs{1000}, TimeRange{0.f}, sampleRate));
+        REQUIRE(check<HasSignalInBandDuring>(signal, {1}, Freqs{8000}, TimeRange{1.1f}, sampleRate));
+        REQUIRE_FALSE(check<HasSignalInBandDuring>(signal, {1}, Freqs{8000}, TimeRange{0.5f}, sampleRate));
+        REQUIRE_FALSE(check<HasSignalInBandDuring>(signal, {1}, Freqs{1000, 8000}, TimeRange{1.1f}, sampleRate));
+        // the spectrum of the entire signal has both frequencies
+        REQUIRE(check<HasSignalInAllBands>(signal, {1}, Freqs{1000, 8000}, sampleRate));
+
+        // no frames in the time range
+        REQUIRE_FALSE(check<HasSignalInBandDuring>(signal, {}, Freqs{1000}, TimeRange{3.f}, sampleRate));
+        REQUIRE_FALSE(check<HasSignalInBandDuring>(signal, {}, Freqs{}, TimeRange{0.f}, sampleRate));
+        // a longer FFT for a finer frequency resolution
+        REQUIRE(check<HasSignalInBandDuring>(signal, {1}, Freqs{{7950, 8050}}, TimeRange{1.2f}, sampleRate, -0.5f, 8192));
+        // hop size and window
+        const STFTSettings settings{1024, WindowType::BlackmanHarris};
+        REQUIRE(check<HasSignalInBandDuring>(signal, {}, Freqs{1000}, TimeRange{0.f, 0.9f}, sampleRate, -0.5f, 1024, settings));
+        REQUIRE_FALSE(check<HasSignalInBandDuring>(signal, {}, Freqs{1000}, TimeRange{0.f, 1.5f}, sampleRate, -0.5f, 1024, settings));
+        REQUIRE_THROWS(check<HasSignalInBandDuring>(signal, {}, Freqs{1000}, TimeRange{0.f}, sampleRate, -0.5f, 1024, STFTSettings{2048, WindowType::Hann}));
+    }
+
+    SECTION("HasSignalOnlyInBandsDuring") {
+        REQUIRE(check<HasSignalOnlyInBandsDuring>(signal, {}, Freqs{{500, 1500}}, TimeRange{0.f, 0.9f}, sampleRate));
+        REQUIRE_FALSE(check<HasSignalOnlyInBandsDuring>(signal, {}, Freqs{{500, 1500}}, TimeRange{0.f, 1.5f}, sampleRate));
+        REQUIRE(check<HasSignalOnlyInBandsDuring>(signal, {1}, Freqs{{7000, 9000}}, TimeRange{1.1f}, sampleRate));
+        REQUIRE_FALSE(check<HasSignalOnlyInBandsDuring>(signal, {}, Freqs{{7000, 9000}}, TimeRange{1.1f}, sampleRate));
+        REQUIRE(check<HasSignalOnlyInBandsDuring>(signal, {}, Freqs{{7000, 9000}}, TimeRange{3.f}, sampleRate)); // no frames
+        // hop size and window
+        const STFTSettings settings{256, WindowType::Hamming};
+        REQUIRE(check<HasSignalOnlyInBandsDuring>(signal, {1}, Freqs{{7000, 9000}}, TimeRange{1.1f}, sampleRate, -0.5f, 1024, settings));
+        REQUIRE_FALSE(check<HasSignalOnlyInBandsDuring>(signal, {}, Freqs{{500, 1500}}, TimeRange{0.f, 1.5f}, sampleRate, -0.5f, 1024, settings));
+    }
+
+    SECTION("Streaming evaluation stops as soon as the result is known") {
+        StreamingCheck<HasSignalInBandDuring> inBand;
+        inBand.begin(1, {}, Freqs{8000}, TimeRange{0.5f}, sampleRate);
+        StreamingCheck<HasSignalInBandDuring> inBandShortRange;
+        inBandShortRange.begin(1, {}, Freqs{1000}, TimeRange{0.5f, 0.6f}, sampleRate);
+
+        constexpr int blockSize = 1000;
+        std::vector<std::vector<float>> blockData(1, std::vector<float>(blockSize));
+        SignalAdapterStdVecVec block(blockData);
+        for (int start = 0; start < 30000; start += blockSize) {
+            std::copy(step.begin() + start, step.begin() + start + blockSize, blockData[0].begin());
+            inBand.process(block);
+            inBandShortRange.process(block);
+        }
+        REQUIRE(inBand.isDecided()); // the first frame in the time range has no signal at 8kHz
+        REQUIRE(inBandShortRange.isDecided()); // the time range is over
+        REQUIRE_FALSE(inBand.finish());
+        REQUIRE(inBandShortRange.finish());
+    }
+
+    SECTION("Interleaved and converted signals") {
+        std::vector<float> interleaved;
+        std::vector<int16_t> interleavedInt16;
+        for (int i = 0; i < static_cast<int>(step.size()); ++i) {
+            for (int ch = 0; ch < 2; ++ch) {
+                interleaved.push_back(buffer[ch][i]);
+                interleavedInt16.push_back(static_cast<int16_t>(buffer[ch][i] * 32767.f));
+            }
+        }
+        SignalAdapterInterleaved interleavedSignal(interleaved.data(), 2, static_cast<int>(step.size()));
+        StaticSignal<Layout::Interleaved, int16_t> int16Signal(interleavedInt16.data(), 2, static_cast<int>(step.size()));
+        REQUIRE(check<HasSignalInBandDuring>(interleavedSignal, {1}, Freqs{8000}, TimeRange{1.1f}, sampleRate));
+        REQUIRE_FALSE(check<HasSignalInBandDuring>(interleavedSignal, {}, Freqs{8000}, TimeRange{1.1f}, sampleRate));
+        REQUIRE(check<HasSignalInBandDuring>(int16Signal, {1}, Freqs{8000}, TimeRange{1.1f}, sampleRate));
+        REQUIRE(check<HasSignalOnlyInBandsDuring>(int16Signal, {}, Freqs{{500, 1500}}, TimeRange{0.f, 0.9f}, sampleRate));
+        REQUIRE_FALSE(check<HasSignalOnlyInBandsDuring>(int16Signal, {}, Freqs{{500, 1500}}, TimeRange{0.f, 1.5f}, sampleRate));
+    }
+}
@@ -0,0 +1,131 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#include "TestCommon.hpp"
+#include "SignalGenerator.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#ifdef SLB_AMALGATED_HEADER
+    #include "AudioTraits.hpp"
+#else
+    #include "AudioTraits.hpp"
+#endif
+
+using namespace slb;
+using namespace slb::AudioTraits;
+using namespace TestCommon;
+
+namespace
+{
+Int24 makeInt24(int32_t value)
+{
+    const uint32_t bits = static_cast<uint32_t>(value);
+    return Int24{{ static_cast<uint8_t>(bits & 0xFF), static_cast<uint8_t>((bits >> 8) & 0xFF), static_cast<uint8_t>((bits >> 16) & 0xFF) }};
+}
+
+/** Quantizes the float samples to the sample type T */
+template<typename T> T quantize(float sample);
+template<> double quantize<double>(float sample) { return sample; }
+template<> int16_t quantize<int16_t>(float sample) { return static_cast<int16_t>(std::lround(sample * 32767.f)); }
+template<> Int24 quantize<Int24>(float sample) { return makeInt24(static_cast<int32_t>(std::lround(sample * 8388607.f))); }
+template<> int32_t quantize<int32_t>(float sample) { return static_cast<int32_t>(std::lround(static_cast<double>(sample) * 2147483647.0)); }
+} // namespace
+
+TEST_CASE("SampleConversion Tests")
+{
+    static_assert(IsSupportedSampleType<float>::value, "");
+    static_assert(IsSupportedSampleType<double>::value, "");
+    static_assert(IsSupportedSampleType<int16_t>::value, "");
+    static_assert(IsSupportedSampleType<Int24>::value, "");
+    static_assert(IsSupportedSampleType<int32_t>::value, "");
+    static_assert(IsSupportedSampleType<char>::value == false, "");
+    static_assert(IsSupportedSampleType<uint16_t>::value == false, "");
+
+    REQUIRE(SampleConversion<double>::toFloat(0.25) == 0.25f);
+
+    REQUIRE(SampleConversion<int16_t>::toFloat(0) == 0.f);
+    REQUIRE(SampleConversion<int16_t>::toFloat(-32768) == -1.f);
+    REQUIRE(SampleConversion<int16_t>::toFloat(16384) == 0.5f);
+    REQUIRE(SampleConversion<int16_t>::toFloat(32767) == 32767.f / 32768.f);
+
+    REQUIRE(SampleConversion<Int24>::toFloat(makeInt24(0)) == 0.f);
+    REQUIRE(SampleConversion<Int24>::toFloat(makeInt24(-8388608)) == -1.f);
+    REQUIRE(SampleConversion<Int24>::toFloat(makeInt24(4194304)) == 0.5f);
+    REQUIRE(SampleConversion<Int24>::toFloat(makeInt24(-4194304)) == -0.5f);
+    REQUIRE(SampleConversion<Int24>::toFloat(makeInt24(-1)) == -1.f / 8388608.f);
+
+    REQUIRE(SampleConversion<int32_t>::toFloat(INT32_MIN) == -1.f);
+    REQUIRE(SampleConversion<int32_t>::toFloat(1 << 30) == 0.5f);
+
+    std::vector<int16_t> interleaved { 0, 16384, -16384, -32768 };
+    std::vector<float> converted(2);
+    convertToFloat(interleaved.data() + 1, 2, 2, converted.data());
+    REQUIRE(converted == std::vector<float>{0.5f, -1.f});
+
+    uint8_t unaligned[5] = { 0, 0x00, 0x40, 0, 0 };
+    REQUIRE(convertUnalignedToFloat<int16_t>(unaligned + 1) == 0.5f);
+}
+
+TEMPLATE_TEST_CASE("StaticSignal with converted sample types", "", double, int16_t, Int24, int32_t)
+{
+    constexpr float sampleRate = 48e3f;
+    constexpr int numChannels = 3;
+    constexpr int numSamples = 5000; // several blocks, with remainder
+
+    std::vector<std::vector<float>> reference { SignalGenerator::createSine<float>(1000, sampleRate, numSamples, -6.f),
+                                                SignalGenerator::createSine<float>(1000, sampleRate, numSamples, -6.f),
+                                                SignalGenerator::createWhiteNoise(numSamples, -20.f, 7) };
+    // typed versions (planar & interleaved) of the reference -- and the reference as the converted values
+    std::vector<std::vector<TestType>> planar(numChannels);
+    std::vector<TestType> interleaved;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        for (int i = 0; i < numSamples; ++i) {
+            planar[ch].push_back(quantize<TestType>(reference[ch][i]));
+            reference[ch][i] = SampleConversion<TestType>::toFloat(planar[ch].back());
+        }
+    }
+    for (int i = 0; i < numSamples; ++i) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            interleaved.push_back(planar[ch][i]);
+        }
+    }
+    SignalAdapterStdVecVec referenceSignal(reference);
+    const TestType* channelPointers[] = { planar[0].data(), planar[1].data(), planar[2].data() };
+    StaticSignal<Layout::Planar, TestType> planarSignal(channelPointers, numChannels, numSamples);
+    StaticSignal<Layout::Interleaved, TestType> interleavedSignal(interleaved.data(), numChannels, numSamples);
+
+    SECTION("Channels are converted through the ISignal interface") {
+        for (const ISignal* signal : std::vector<const ISignal*>{&planarSignal, &interleavedSignal}) {
+            REQUIRE(signal->getData() == nullptr);
+            for (int ch = 0; ch < numChannels; ++ch) {
+                REQUIRE(signal->getChannelDataCopy(ch) == reference[ch]);
+                REQUIRE(signal->getChannelView(ch).data() == signal->getChannelView(ch).data()); // converted once
+            }
+        }
+        REQUIRE(interleavedSignal.getStride() == numChannels);
+        REQUIRE(interleavedSignal.getChannelStart(1) == interleaved.data() + 1);
+    }
+
+    SECTION("Traits evaluated on converted blocks agree with the float signal") {
+        for (const ChannelSelection& channels : {ChannelSelection{}, ChannelSelection{1}, ChannelSelection{1, 2}, ChannelSelection{3}}) {
+            REQUIRE(check<HasSignalOnAllChannels>(planarSignal, channels, -10.f) == check<HasSignalOnAllChannels>(referenceSignal, channels, -10.f));
+            REQUIRE(check<HasSignalOnAllChannels>(interleavedSignal, channels, -10.f) == check<HasSignalOnAllChannels>(referenceSignal, channels, -10.f));
+            REQUIRE(check<HasIdenticalChannels>(planarSignal, channels) == check<HasIdenticalChannels>(referenceSignal, channels));
+            REQUIRE(check<HasIdenticalChannels>(interleavedSignal, channels) == check<HasIdenticalChannels>(referenceSignal, channels));
+            REQUIRE(check<HaveIdenticalChannels>(planarSignal, channels, referenceSignal));
+            REQUIRE(check<HaveIdenticalChannels>(interleavedSignal, channels, planarSignal));
+            REQUIRE(check<IsDelayedVersionOf>(interleavedSignal, channels, referenceSignal, 0));
+            REQUIRE(check<HasSignalOnlyBelow>(planarSignal, channels, 1500.f, sampleRate) == check<HasSignalOnlyBelow>(referenceSignal, channels, 1500.f, sampleRate));
+            REQUIRE(check<HasSignalInAllBands>(interleavedSignal, channels, Freqs{1000}, sampleRate)
+                    == check<HasSignalInAllBands>(referenceSignal, channels, Freqs{1000}, sampleRate));
+        }
+    }
+}
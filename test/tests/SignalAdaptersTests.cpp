@@ -10,15 +10,59 @@
 #include "SignalGenerator.hpp"
 #include "AudioFileSignalAdapter.hpp"
 
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
 #ifdef SLB_AMALGATED_HEADER
 #include "AudioTraits.hpp"
 #else
-#include "SignalAdapters.hpp"
+#include "AudioTraits.hpp"
 #endif
+#include "MappedWavSignalAdapter.hpp" // optional, not part of AudioTraits.hpp
 
 using namespace TestCommon;
 using namespace slb;
 
+namespace
+{
+/** Writes a WAV file with the given (interleaved) sample data and format */
+void writeWavFile(const std::string& path, int numChannels, int bitsPerSample, bool isFloat, const std::vector<uint8_t>& sampleData,
+                  bool isExtensible = false, bool hasExtraChunk = false)
+{
+    std::vector<uint8_t> bytes;
+    auto append = [&bytes](const void* data, size_t size) { bytes.insert(bytes.end(), (const uint8_t*) data, (const uint8_t*) data + size); };
+    auto append16 = [&append](uint16_t value) { append(&value, 2); };
+    auto append32 = [&append](uint32_t value) { append(&value, 4); };
+
+    append("RIFF", 4); append32(0 /*not checked*/); append("WAVE", 4);
+    if (hasExtraChunk) {
+        append("LIST", 4); append32(3); append("abc", 3); bytes.push_back(0); // odd size -> padding byte
+    }
+    const uint16_t formatTag = isFloat ? 3 : 1;
+    append("fmt ", 4); append32(isExtensible ? 40 : 16);
+    append16(isExtensible ? 0xFFFE : formatTag);
+    append16((uint16_t) numChannels);
+    append32(48000);
+    append32((uint32_t) (48000 * numChannels * bitsPerSample / 8));
+    append16((uint16_t) (numChannels * bitsPerSample / 8));
+    append16((uint16_t) bitsPerSample);
+    if (isExtensible) {
+        append16(22); append16((uint16_t) bitsPerSample); append32(0);
+        append16(formatTag); // sub-format GUID
+        const uint8_t guidRest[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+        append(guidRest, 14);
+    }
+    append("data", 4); append32((uint32_t) sampleData.size());
+    append(sampleData.data(), sampleData.size());
+
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char*) bytes.data(), (std::streamsize) bytes.size());
+}
+} // namespace
+
 TEST_CASE("SignalAdapters Test AudioFile Adapter")
 {
     std::string path = resolveTestFile("sin_1000Hz_-3dBFS_0.1s_2ch.wav");
@@ -70,3 +114,238 @@ TEST_CASE("SignalAdapters Test std::vector<vector>> Adapter")
     // check that adapter cannot be constructed from an rvalue (without a stack object)
     static_assert(std::is_constructible<SignalAdapterStdVecVec, std::vector<std::vector<float>>>::value == false, "cannot construct from a vector<vector> r-value!");
 }
+
+TEST_CASE("SignalAdapters Test Channel Views")
+{
+    using namespace slb::AudioTraits;
+    
+    std::vector<std::vector<float>> vecvec{SignalGenerator::createWhiteNoise(16, 0.f, 333), SignalGenerator::createWhiteNoise(16, 0.f, 666)};
+    SignalAdapterStdVecVec adaptedVecVec(vecvec);
+    float* rawBuffer[] = { vecvec[0].data(), vecvec[1].data() };
+    SignalAdapterRaw adaptedRaw(rawBuffer, 2, 16);
+
+    for (const ISignal* signal : std::vector<const ISignal*>{&adaptedVecVec, &adaptedRaw}) {
+        for (int channelIndex = 0; channelIndex < 2; ++channelIndex) {
+            ChannelView view = signal->getChannelView(channelIndex);
+            REQUIRE(view.size() == 16);
+            REQUIRE(view.isContiguous());
+            REQUIRE(view.data() == vecvec[channelIndex].data()); // no copy
+            REQUIRE(view.copy() == signal->getChannelDataCopy(channelIndex));
+        }
+        REQUIRE_THROWS(signal->getChannelView(2));
+        REQUIRE_THROWS(signal->getChannelView(-1));
+    }
+    
+    static_assert(std::is_assignable<decltype(adaptedVecVec.getChannelView(0)[0]), float>::value == false, "Cannot modify audio data");
+
+    SECTION("Strided views & sub-views") {
+        std::vector<float> interleaved { 0, 10, 1, 11, 2, 12, 3, 13 };
+        ChannelView second(interleaved.data() + 1, 4, 2);
+        REQUIRE_FALSE(second.isContiguous());
+        REQUIRE(second.getStride() == 2);
+        REQUIRE(second.copy() == std::vector<float>{10, 11, 12, 13});
+        
+        ChannelView sub = second.subView(1, 2);
+        REQUIRE(sub.size() == 2);
+        REQUIRE(sub.getStride() == 2);
+        REQUIRE(sub.copy() == std::vector<float>{11, 12});
+        REQUIRE(second.subView(4, 0).size() == 0);
+        REQUIRE_THROWS(second.subView(3, 2));
+        REQUIRE_THROWS(second.subView(-1, 2));
+        REQUIRE_THROWS(ChannelView(interleaved.data(), 4, 0));
+    }
+}
+
+TEST_CASE("SignalAdapters Test Interleaved Adapter")
+{
+    using namespace slb::AudioTraits;
+    
+    constexpr int numChannels = 3;
+    constexpr int numSamples = 5000;
+    constexpr float sampleRate = 48e3f;
+    auto sine = SignalGenerator::createSine<float>(1000, sampleRate, numSamples);
+    auto noise = SignalGenerator::createWhiteNoise(numSamples, -10.f, 333);
+    auto silence = SignalGenerator::createSilence<float>(numSamples);
+    std::vector<std::vector<float>> planar { sine, noise, silence };
+    SignalAdapterStdVecVec planarSignal(planar);
+    
+    std::vector<float> interleaved;
+    for (int i = 0; i < numSamples; ++i) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            interleaved.push_back(planar[ch][i]);
+        }
+    }
+    SignalAdapterInterleaved interleavedSignal(interleaved, numChannels);
+    REQUIRE(interleavedSignal.getNumChannels() == numChannels);
+    REQUIRE(interleavedSignal.getNumSamples() == numSamples);
+    REQUIRE(interleavedSignal.getData() == nullptr);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        ChannelView view = interleavedSignal.getChannelView(ch);
+        REQUIRE(view.data() == interleaved.data() + ch); // no copy
+        REQUIRE(view.getStride() == numChannels);
+        REQUIRE(interleavedSignal.getChannelDataCopy(ch) == planar[ch]);
+    }
+    REQUIRE_THROWS(interleavedSignal.getChannelView(numChannels));
+    REQUIRE_THROWS(SignalAdapterInterleaved(interleaved, 7)); // not a multiple
+    
+    SignalAdapterInterleaved mono(interleaved.data(), 1, 10);
+    REQUIRE(mono.getData()[0] == interleaved.data());
+    
+    static_assert(std::is_constructible<SignalAdapterInterleaved, std::vector<float>, int>::value == false, "cannot construct from a vector r-value!");
+    
+    // traits give the same results as on the planar signal
+    for (const ChannelSelection& channels : {ChannelSelection{}, ChannelSelection{1}, ChannelSelection{1, 2}, ChannelSelection{3}}) {
+        REQUIRE(check<HasSignalOnAllChannels>(interleavedSignal, channels) == check<HasSignalOnAllChannels>(planarSignal, channels));
+        REQUIRE(check<HasIdenticalChannels>(interleavedSignal, channels) == check<HasIdenticalChannels>(planarSignal, channels));
+        REQUIRE(check<HaveIdenticalChannels>(interleavedSignal, channels, planarSignal));
+        REQUIRE(check<IsDelayedVersionOf>(interleavedSignal, channels, planarSignal, 0));
+        REQUIRE(check<HasSignalOnlyBelow>(interleavedSignal, channels, 1500.f, sampleRate) == check<HasSignalOnlyBelow>(planarSignal, channels, 1500.f, sampleRate));
+    }
+}
+
+TEST_CASE("SignalAdapters Test Static Signal")
+{
+    using namespace slb::AudioTraits;
+    
+    constexpr int numChannels = 2;
+    constexpr int numSamples = 3000;
+    std::vector<std::vector<float>> planar { SignalGenerator::createWhiteNoise(numSamples, -10.f, 1), SignalGenerator::createSilence<float>(numSamples) };
+    SignalAdapterStdVecVec dynamicSignal(planar);
+    std::vector<float> interleaved;
+    for (int i = 0; i < numSamples; ++i) {
+        interleaved.push_back(planar[0][i]);
+        interleaved.push_back(planar[1][i]);
+    }
+    
+    const float* channelPointers[] = { planar[0].data(), planar[1].data() };
+    StaticSignal<Layout::Planar> planarSignal(channelPointers, numChannels, numSamples);
+    StaticSignal<Layout::Interleaved> interleavedSignal(interleaved.data(), numChannels, numSamples);
+    
+    REQUIRE(planarSignal.getData() == channelPointers);
+    REQUIRE(interleavedSignal.getData() == nullptr);
+    REQUIRE(planarSignal.getChannelView(1).isContiguous());
+    REQUIRE(interleavedSignal.getChannelView(1).getStride() == numChannels);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        REQUIRE(planarSignal.getChannelDataCopy(ch) == planar[ch]);
+        REQUIRE(interleavedSignal.getChannelDataCopy(ch) == planar[ch]);
+    }
+    REQUIRE_THROWS(planarSignal.getChannelView(2));
+    REQUIRE_THROWS(interleavedSignal.getChannelView(-1));
+    
+    for (const ChannelSelection& channels : {ChannelSelection{}, ChannelSelection{1}, ChannelSelection{2}}) {
+        for (const ISignal* signal : std::vector<const ISignal*>{&planarSignal, &interleavedSignal}) {
+            // statically (template overload) and dynamically (through ISignal) dispatched evaluations agree
+            const bool hasSignal = check<HasSignalOnAllChannels>(dynamicSignal, channels);
+            REQUIRE(check<HasSignalOnAllChannels>(*signal, channels) == hasSignal);
+            REQUIRE(check<HasSignalOnAllChannels>(planarSignal, channels) == hasSignal);
+            REQUIRE(check<HasSignalOnAllChannels>(interleavedSignal, channels) == hasSignal);
+            REQUIRE(check<HasIdenticalChannels>(planarSignal, channels) == check<HasIdenticalChannels>(*signal, channels));
+            REQUIRE(check<HaveIdenticalChannels>(interleavedSignal, channels, *signal));
+            REQUIRE(check<IsDelayedVersionOf>(planarSignal, channels, *signal, 0));
+            REQUIRE(check<HasSignalOnlyBelow>(interleavedSignal, channels, 1000.f, 48e3f) == check<HasSignalOnlyBelow>(dynamicSignal, channels, 1000.f, 48e3f));
+        }
+    }
+}
+
+TEST_CASE("SignalAdapters Test Mapped WAV Adapter")
+{
+    using namespace slb::AudioTraits;
+    
+    constexpr int numChannels = 3;
+    constexpr int numFrames = 1000;
+    std::vector<std::vector<float>> expected(numChannels);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        expected[ch] = SignalGenerator::createWhiteNoise(numFrames, -6.f, 100 + ch);
+    }
+    const std::string path = "MappedWavAdapterTest.wav";
+    
+    SECTION("32-bit float: accessed in place") {
+        const bool hasExtraChunk = GENERATE(false, true);
+        std::vector<float> interleaved;
+        for (int i = 0; i < numFrames; ++i) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                interleaved.push_back(expected[ch][i]);
+            }
+        }
+        std::vector<uint8_t> sampleData((const uint8_t*) interleaved.data(), (const uint8_t*) (interleaved.data() + interleaved.size()));
+        writeWavFile(path, numChannels, 32, true, sampleData, false, hasExtraChunk);
+        {
+            SignalAdapterMappedWav wav(path);
+            REQUIRE(wav.getNumChannels() == numChannels);
+            REQUIRE(wav.getNumSamples() == numFrames);
+            REQUIRE(wav.getSampleRate() == 48000.f);
+            REQUIRE(wav.isFloatingPoint());
+            REQUIRE(wav.getData() == nullptr); // interleaved
+            for (int ch = 0; ch < numChannels; ++ch) {
+                ChannelView view = wav.getChannelView(ch);
+                REQUIRE(view.getStride() == numChannels);
+                REQUIRE(view.copy() == expected[ch]);
+                REQUIRE(wav.getChannelDataCopy(ch) == expected[ch]);
+            }
+            REQUIRE_THROWS(wav.getChannelView(numChannels));
+            
+            // traits work directly on the mapped file
+            std::vector<std::vector<float>> expectedCopy = expected;
+            SignalAdapterStdVecVec expectedSignal(expectedCopy);
+            REQUIRE(check<HaveIdenticalChannels>(wav, {}, expectedSignal));
+            REQUIRE(check<HasSignalOnAllChannels>(wav, {}));
+        }
+        std::remove(path.c_str());
+    }
+    
+    SECTION("Integer PCM: converted on access") {
+        const int bitsPerSample = GENERATE(16, 24, 32);
+        const bool isExtensible = GENERATE(false, true);
+        const int bytesPerSample = bitsPerSample / 8;
+        std::vector<uint8_t> sampleData;
+        for (int i = 0; i < numFrames; ++i) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                // quantize the expected value to the bit depth
+                const double fullScale = std::pow(2.0, bitsPerSample - 1);
+                const long value = std::lround(expected[ch][i] * fullScale);
+                expected[ch][i] = (float) ((double) value / fullScale);
+                for (int b = 0; b < bytesPerSample; ++b) {
+                    sampleData.push_back((uint8_t) ((value >> (8 * b)) & 0xFF)); // little-endian
+                }
+            }
+        }
+        writeWavFile(path, numChannels, bitsPerSample, false, sampleData, isExtensible);
+        {
+            SignalAdapterMappedWav wav(path);
+            REQUIRE(wav.getNumChannels() == numChannels);
+            REQUIRE(wav.getNumSamples() == numFrames);
+            REQUIRE(wav.getBitsPerSample() == bitsPerSample);
+            REQUIRE_FALSE(wav.isFloatingPoint());
+            for (int ch = numChannels - 1; ch >= 0; --ch) {
+                ChannelView view = wav.getChannelView(ch);
+                REQUIRE(view.isContiguous());
+                REQUIRE(view.copy() == expected[ch]);
+                REQUIRE(wav.getChannelView(ch).data() == view.data()); // converted only once
+            }
+        }
+        std::remove(path.c_str());
+    }
+    
+    SECTION("Test data file") {
+        SignalAdapterMappedWav wav(resolveTestFile("sin_1000Hz_-3dBFS_0.1s_2ch.wav"));
+        REQUIRE(wav.getNumChannels() == 2);
+        REQUIRE(wav.getNumSamples() == 4801);
+        REQUIRE(wav.getBitsPerSample() == 16);
+        REQUIRE(check<HasSignalOnAllChannels>(wav, {}, -4.f));
+        REQUIRE_FALSE(check<HasSignalOnAllChannels>(wav, {}, -2.f));
+        REQUIRE(check<HasIdenticalChannels>(wav, {}));
+    }
+    
+    SECTION("Invalid files") {
+        REQUIRE_THROWS(SignalAdapterMappedWav("DoesNotExist.wav"));
+        REQUIRE_THROWS(SignalAdapterMappedWav(resolveTestFile("generate_bandlimited_noise.m")));
+        writeWavFile(path, 1, 8, false, std::vector<uint8_t>(16)); // 8-bit is not supported
+        REQUIRE_THROWS(SignalAdapterMappedWav(path));
+        std::remove(path.c_str());
+        
+        std::ofstream(path, std::ios::binary).close(); // empty files cannot be mapped
+        REQUIRE_THROWS(MemoryMappedFile(path));
+        REQUIRE_THROWS(SignalAdapterMappedWav(path));
+        std::remove(path.c_str());
+    }
+}
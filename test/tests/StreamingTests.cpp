@@ -0,0 +1,206 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#include "TestCommon.hpp"
+#include "SignalGenerator.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#ifdef SLB_AMALGATED_HEADER
+    #include "AudioTraits.hpp"
+#else
+    #include "AudioTraits.hpp"
+#endif
+
+using namespace slb;
+using namespace slb::AudioTraits;
+using namespace TestCommon;
+
+namespace
+{
+/** Passes the signal to a StreamingCheck in blocks of blockSize (the last one may be shorter) */
+template<typename F, typename ... Is>
+bool checkStreaming(const ISignal& signal, int blockSize, const ChannelSelection& channelSelection, Is&& ... traitParams)
+{
+    StreamingCheck<F> streamingCheck;
+    streamingCheck.begin(signal.getNumChannels(), channelSelection, std::forward<Is>(traitParams)...);
+    for (int blockStart = 0; blockStart < signal.getNumSamples(); blockStart += blockSize) {
+        const int blockLength = std::min(blockSize, signal.getNumSamples() - blockStart);
+        streamingCheck.process(getSignalBlock(signal, blockStart, blockLength));
+    }
+    return streamingCheck.finish();
+}
+
+std::vector<float> delayed(const std::vector<float>& x, int delay)
+{
+    std::vector<float> result(x.size(), 0.f);
+    std::copy(x.begin(), x.end() - delay, result.begin() + delay);
+    return result;
+}
+} // namespace
+
+TEST_CASE("StreamingCheck Tests - time domain")
+{
+    constexpr int signalLength = 3000;
+    const int blockSize = GENERATE(1, 7, 1000, 3000 /*entire signal*/);
+
+    auto noise = SignalGenerator::createWhiteNoise(signalLength, 0.f, 21 /*seed*/);
+    auto silence = SignalGenerator::createSilence<float>(signalLength);
+    std::vector<std::vector<float>> referenceData { noise, noise, noise, silence };
+    SignalAdapterStdVecVec reference(referenceData);
+    std::vector<std::vector<float>> buffer { noise, noise, delayed(noise, 3), silence };
+    SignalAdapterStdVecVec signal(buffer);
+
+    for (const ChannelSelection& channels : {ChannelSelection{}, ChannelSelection{1}, ChannelSelection{1, 2},
+                                             ChannelSelection{3}, ChannelSelection{3, 4}, ChannelSelection{4}}) {
+        REQUIRE(checkStreaming<HasSignalOnAllChannels>(signal, blockSize, channels) == check<HasSignalOnAllChannels>(signal, channels));
+        REQUIRE(checkStreaming<HasSignalOnAllChannels>(signal, blockSize, channels, 6.f) == check<HasSignalOnAllChannels>(signal, channels, 6.f));
+        REQUIRE(checkStreaming<HasIdenticalChannels>(signal, blockSize, channels) == check<HasIdenticalChannels>(signal, channels));
+        REQUIRE(checkStreaming<HaveIdenticalChannels>(signal, blockSize, channels, reference) == check<HaveIdenticalChannels>(signal, channels, reference));
+        for (int delay : {0, 2, 3}) {
+            for (int timeTolerance : {0, 1, 5}) {
+                REQUIRE(checkStreaming<IsDelayedVersionOf>(signal, blockSize, channels, reference, delay, 0.f, timeTolerance)
+                        == check<IsDelayedVersionOf>(signal, channels, reference, delay, 0.f, timeTolerance));
+            }
+        }
+    }
+    REQUIRE(checkStreaming<IsDelayedVersionOf>(signal, blockSize, {3}, reference, 3));
+    REQUIRE(checkStreaming<IsDelayedVersionOf>(signal, blockSize, {3}, reference, 1, 0.f, 2));
+    REQUIRE_FALSE(checkStreaming<IsDelayedVersionOf>(signal, blockSize, {3}, reference, 1, 0.f, 1));
+
+    SECTION("negative jittered delays compare the signal with itself") {
+        // only a silent signal matches itself delayed -- and it does not match the (noise) reference for any delay >= 0
+        std::vector<std::vector<float>> silenceData { silence };
+        SignalAdapterStdVecVec silentSignal(silenceData);
+        std::vector<std::vector<float>> noiseData { noise };
+        SignalAdapterStdVecVec noiseSignal(noiseData);
+        REQUIRE(check<IsDelayedVersionOf>(silentSignal, {}, noiseSignal, 0, 0.f, 2));
+        REQUIRE(checkStreaming<IsDelayedVersionOf>(silentSignal, blockSize, {}, noiseSignal, 0, 0.f, 2));
+        REQUIRE(checkStreaming<IsDelayedVersionOf>(silentSignal, blockSize, {}, noiseSignal, 1, 0.f, 5));
+        REQUIRE_FALSE(checkStreaming<IsDelayedVersionOf>(silentSignal, blockSize, {}, noiseSignal, 2, 0.f, 1));
+    }
+}
+
+TEST_CASE("StreamingCheck Tests - frequency domain")
+{
+    constexpr float sampleRate = 48e3f;
+    constexpr int signalLength = 10000;
+    const int blockSize = GENERATE(1, 7, 1000, 10000 /*entire signal*/);
+
+    auto sine1k = SignalGenerator::createSine<float>(1000, sampleRate, signalLength);
+    auto sine2k = SignalGenerator::createSine<float>(2000, sampleRate, signalLength);
+    std::vector<std::vector<float>> buffer { sine1k, sine2k, sine2k };
+    SignalAdapterStdVecVec signal(buffer);
+
+    for (const ChannelSelection& channels : {ChannelSelection{}, ChannelSelection{1}, ChannelSelection{2, 3}}) {
+        REQUIRE(checkStreaming<HasSignalInAllBands>(signal, blockSize, channels, Freqs{1000}, sampleRate)
+                == check<HasSignalInAllBands>(signal, channels, Freqs{1000}, sampleRate));
+        REQUIRE(checkStreaming<HasSignalInAllBands>(signal, blockSize, channels, Freqs{2000}, sampleRate, -0.5f, 1024)
+                == check<HasSignalInAllBands>(signal, channels, Freqs{2000}, sampleRate, -0.5f, 1024));
+        REQUIRE(checkStreaming<HasSignalOnlyInBands>(signal, blockSize, channels, Freqs{{900, 1100}}, sampleRate)
+                == check<HasSignalOnlyInBands>(signal, channels, Freqs{{900, 1100}}, sampleRate));
+        REQUIRE(checkStreaming<HasSignalOnlyBelow>(signal, blockSize, channels, 1500.f, sampleRate)
+                == check<HasSignalOnlyBelow>(signal, channels, 1500.f, sampleRate));
+        REQUIRE(checkStreaming<HasSignalOnlyAbove>(signal, blockSize, channels, 1500.f, sampleRate, -0.5f, 512)
+                == check<HasSignalOnlyAbove>(signal, channels, 1500.f, sampleRate, -0.5f, 512));
+    }
+    REQUIRE(checkStreaming<HasSignalInAllBands>(signal, blockSize, {1}, Freqs{1000}, sampleRate));
+    REQUIRE_FALSE(checkStreaming<HasSignalInAllBands>(signal, blockSize, {}, Freqs{1000}, sampleRate));
+    REQUIRE_FALSE(checkStreaming<HasSignalInAllBands>(signal, blockSize, {}, Freqs{}, sampleRate));
+    REQUIRE(checkStreaming<HasSignalOnlyAbove>(signal, blockSize, {2, 3}, 1500.f, sampleRate));
+}
+
+TEST_CASE("StreamingCheck Tests - HasDelayOf")
+{
+    constexpr int signalLength = 24000;
+    const int blockSize = GENERATE(7, 1000, 24000 /*entire signal*/);
+
+    std::vector<float> noise1 = SignalGenerator::createWhiteNoise(signalLength, 0.f, 11 /*seed*/);
+    std::vector<float> noise2 = SignalGenerator::createWhiteNoise(signalLength, 0.f, 12 /*seed*/);
+    std::vector<std::vector<float>> referenceData { noise1, noise2 };
+    SignalAdapterStdVecVec reference(referenceData);
+
+    const int delay = GENERATE(0, 2500);
+    std::vector<std::vector<float>> signalData { delayed(noise1, delay), delayed(noise2, delay + 100) };
+    SignalAdapterStdVecVec signal(signalData);
+
+    REQUIRE(checkStreaming<HasDelayOf>(signal, blockSize, {1}, reference, delay));
+    REQUIRE(checkStreaming<HasDelayOf>(signal, blockSize, {2}, reference, delay + 100));
+    REQUIRE_FALSE(checkStreaming<HasDelayOf>(signal, blockSize, {}, reference, delay));
+    REQUIRE_FALSE(checkStreaming<HasDelayOf>(signal, blockSize, {1}, reference, delay + 1));
+    REQUIRE(checkStreaming<HasDelayOf>(signal, blockSize, {}, reference, delay + 50, 50));
+    REQUIRE_FALSE(checkStreaming<HasDelayOf>(signal, blockSize, {}, reference, delay + 50, 49));
+    REQUIRE(checkStreaming<HasDelayOf>(reference, blockSize, {1}, signal, -delay));
+}
+
+TEST_CASE("StreamingCheck Tests - usage")
+{
+    constexpr int signalLength = 1000;
+    auto noise = SignalGenerator::createWhiteNoise(signalLength);
+    auto silence = SignalGenerator::createSilence<float>(signalLength);
+    std::vector<std::vector<float>> buffer { silence, noise };
+    SignalAdapterStdVecVec signal(buffer);
+
+    StreamingCheck<HasSignalOnAllChannels> streamingCheck;
+    REQUIRE_THROWS(streamingCheck.process(signal)); // not started
+    REQUIRE_THROWS(streamingCheck.finish());
+    REQUIRE_THROWS(streamingCheck.begin(2, {3}));   // invalid channel selection
+
+    SECTION("Result is decided early") {
+        streamingCheck.begin(2, {2});
+        REQUIRE_FALSE(streamingCheck.isDecided());
+        streamingCheck.process(getSignalBlock(signal, 0, 10));
+        REQUIRE(streamingCheck.isDecided());
+        REQUIRE(streamingCheck.finish());
+        REQUIRE_THROWS(streamingCheck.finish()); // has to begin again
+    }
+    SECTION("Undecided until the end") {
+        streamingCheck.begin(2, {});
+        streamingCheck.process(getSignalBlock(signal, 0, 10));
+        REQUIRE_FALSE(streamingCheck.isDecided());
+        REQUIRE_FALSE(streamingCheck.finish());
+    }
+    SECTION("Invalid blocks") {
+        streamingCheck.begin(3, {});
+        REQUIRE_THROWS(streamingCheck.process(signal)); // channel count mismatch
+        REQUIRE_THROWS(streamingCheck.finish());        // no samples
+    }
+    SECTION("Reference too short") {
+        StreamingCheck<HaveIdenticalChannels> identicalCheck;
+        identicalCheck.begin(2, {}, signal);
+        identicalCheck.process(signal);
+        REQUIRE_THROWS(identicalCheck.process(signal)); // longer than signalB
+
+        StreamingCheck<IsDelayedVersionOf> delayedCheck;
+        delayedCheck.begin(2, {1}, signal, 900);
+        delayedCheck.process(signal);
+        REQUIRE_THROWS(delayedCheck.finish()); // delay more than 80%
+    }
+}
+
+TEST_CASE("SpectrumAccumulator Tests")
+{
+    constexpr int signalLength = 10000;
+    const int fftLength = GENERATE(16, 1024, 4096);
+    const int blockSize = GENERATE(1, 100, 10000 /*entire signal*/);
+    const FrequencyDomainHelpers::BinScale scale = GENERATE(FrequencyDomainHelpers::BinScale::Magnitude, FrequencyDomainHelpers::BinScale::Power);
+    auto noise = SignalGenerator::createWhiteNoise(signalLength);
+
+    FrequencyDomainHelpers::SpectrumAccumulator accumulator(fftLength, WindowType::Hann, scale);
+    for (int blockStart = 0; blockStart < signalLength; blockStart += blockSize) {
+        const int blockLength = std::min(blockSize, signalLength - blockStart);
+        accumulator.process(ChannelView(noise.data() + blockStart, blockLength));
+    }
+    const std::vector<float> expected = FrequencyDomainHelpers::getNormalizedBinValues(ChannelView(noise.data(), signalLength), fftLength,
+                                                                                        WindowType::Hann, scale);
+    REQUIRE(accumulator.getNormalizedBinValues() == expected);
+    REQUIRE(accumulator.getNormalizedBinValues() == expected); // result stays the same
+
+    REQUIRE_THROWS(FrequencyDomainHelpers::SpectrumAccumulator(1000));
+}
@@ -0,0 +1,167 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#include "TestCommon.hpp"
+#include "SignalGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#ifdef SLB_AMALGATED_HEADER
+    #include "AudioTraits.hpp"
+#else
+    #include "AudioTraits.hpp"
+#endif
+
+using namespace slb;
+using namespace slb::AudioTraits;
+using namespace TestCommon;
+
+namespace
+{
+ChannelView view(const std::vector<float>& samples) { return { samples.data(), static_cast<int>(samples.size()) }; }
+
+/** @returns the relative standard deviation of the bins in [firstBin, lastBin) */
+float calculateRelativeSpread(const std::vector<float>& bins, int firstBin, int lastBin)
+{
+    const float numBins = static_cast<float>(lastBin - firstBin);
+    const float mean = std::accumulate(bins.begin() + firstBin, bins.begin() + lastBin, 0.f) / numBins;
+    float variance = 0;
+    for (int k = firstBin; k < lastBin; ++k) {
+        variance += (bins[k] - mean) * (bins[k] - mean) / numBins;
+    }
+    return std::sqrt(variance) / mean;
+}
+} // namespace
+
+TEST_CASE("WelchEstimator Tests")
+{
+    constexpr float sampleRate = 48e3f;
+    constexpr int fftLength = 1024;
+    constexpr int signalLength = 48000;
+
+    SECTION("Invalid settings") {
+        REQUIRE_THROWS(WelchEstimator(1000));
+        REQUIRE_THROWS(WelchEstimator(fftLength, WelchSettings{1.f, Averaging::Mean, WindowType::Hann}));
+        REQUIRE_THROWS(WelchEstimator(fftLength, WelchSettings{-0.1f, Averaging::Mean, WindowType::Hann}));
+    }
+
+    SECTION("Frames and hop size") {
+        auto silence = SignalGenerator::createSilence<float>(4096);
+        WelchEstimator halfOverlap(fftLength, WelchSettings{0.5f, Averaging::Mean, WindowType::Hann});
+        REQUIRE(halfOverlap.getHopSize() == 512);
+        halfOverlap.process(view(silence));
+        REQUIRE(halfOverlap.getNumFrames() == 7);
+
+        WelchEstimator noOverlap(fftLength, WelchSettings{0.f, Averaging::Mean, WindowType::Hann});
+        REQUIRE(noOverlap.getHopSize() == fftLength);
+        noOverlap.process(view(silence));
+        REQUIRE(noOverlap.getNumFrames() == 4);
+
+        // shorter than one frame: zero-padded
+        WelchEstimator shortSignal(fftLength);
+        auto shortSine = SignalGenerator::createSine<float>(1000, sampleRate, 500);
+        shortSignal.process(view(shortSine));
+        REQUIRE(shortSignal.getPowerSpectrum().size() == 513);
+        REQUIRE(shortSignal.getNumFrames() == 1);
+    }
+
+    SECTION("Silent and empty signals: all bins 0") {
+        const std::vector<float> silence = SignalGenerator::createSilence<float>(4096);
+        for (Averaging averaging : {Averaging::Mean, Averaging::Median, Averaging::MaxHold}) {
+            const WelchSettings settings{0.5f, averaging, WindowType::Hann};
+            const std::vector<float> bins = FrequencyDomainHelpers::getWelchNormalizedBinValues(view(silence), fftLength, settings);
+            REQUIRE(bins.size() == 513);
+            REQUIRE(std::all_of(bins.begin(), bins.end(), [](float binValue) { return binValue == 0.f; }));
+
+            WelchEstimator noSamples(fftLength, settings);
+            const std::vector<float> noBins = noSamples.getNormalizedBinValues();
+            REQUIRE(std::all_of(noBins.begin(), noBins.end(), [](float binValue) { return binValue == 0.f; }));
+        }
+    }
+
+    SECTION("Sine: peak at the expected bin") {
+        auto sine = SignalGenerator::createSine<float>(1000, sampleRate, signalLength, -6.f);
+        for (Averaging averaging : {Averaging::Mean, Averaging::Median, Averaging::MaxHold}) {
+            std::vector<float> bins = FrequencyDomainHelpers::getWelchNormalizedBinValues(view(sine), fftLength,
+                                                                                           WelchSettings{0.5f, averaging, WindowType::Hann});
+            const auto peak = std::max_element(bins.begin(), bins.end());
+            REQUIRE(*peak == 1.f);
+            REQUIRE(std::distance(bins.begin(), peak) == 21); // 1000 Hz / (48000 Hz / 1024)
+            REQUIRE(bins[0] == 0.f);
+            REQUIRE(bins[100] < 1e-3f);
+        }
+    }
+
+    SECTION("Result does not depend on the block size") {
+        auto noise = SignalGenerator::createWhiteNoise(10000, -6.f, 3);
+        for (Averaging averaging : {Averaging::Mean, Averaging::Median, Averaging::MaxHold}) {
+            const WelchSettings settings{0.75f, averaging, WindowType::Hann};
+            WelchEstimator wholeSignal(fftLength, settings);
+            wholeSignal.process(view(noise));
+            const std::vector<float> expected = wholeSignal.getPowerSpectrum();
+
+            for (int blockSize : {1, 37, 1000}) {
+                WelchEstimator blockwise(fftLength, settings);
+                for (int start = 0; start < static_cast<int>(noise.size()); start += blockSize) {
+                    const int length = std::min(blockSize, static_cast<int>(noise.size()) - start);
+                    blockwise.process(ChannelView(noise.data() + start, length));
+                }
+                REQUIRE(blockwise.getNumFrames() == wholeSignal.getNumFrames());
+                REQUIRE(blockwise.getPowerSpectrum() == expected);
+            }
+        }
+    }
+
+    SECTION("Overlap lowers the variance of the estimate") {
+        auto noise = SignalGenerator::createWhiteNoise(signalLength, -6.f, 11);
+        std::vector<float> noOverlap = FrequencyDomainHelpers::getWelchNormalizedBinValues(view(noise), fftLength,
+                                                                                           WelchSettings{0.f, Averaging::Mean, WindowType::Hann});
+        std::vector<float> halfOverlap = FrequencyDomainHelpers::getWelchNormalizedBinValues(view(noise), fftLength,
+                                                                                             WelchSettings{0.5f, Averaging::Mean, WindowType::Hann});
+        REQUIRE(calculateRelativeSpread(halfOverlap, 10, 500) < 0.9f * calculateRelativeSpread(noOverlap, 10, 500));
+    }
+
+    SECTION("Median is robust to a click, max-hold keeps it") {
+        auto signal = SignalGenerator::createSine<float>(1000, sampleRate, signalLength, -6.f);
+        signal[signalLength / 2 + fftLength / 4] += 10.f;
+        auto median = FrequencyDomainHelpers::getWelchNormalizedBinValues(view(signal), fftLength,
+                                                                          WelchSettings{0.5f, Averaging::Median, WindowType::Hann});
+        auto maxHold = FrequencyDomainHelpers::getWelchNormalizedBinValues(view(signal), fftLength,
+                                                                           WelchSettings{0.5f, Averaging::MaxHold, WindowType::Hann});
+        REQUIRE(median[400] < 1e-3f);
+        REQUIRE(maxHold[400] > 1e-2f);
+    }
+}
+
+TEST_CASE("AnalyzedSignal with Welch spectra")
+{
+    constexpr float sampleRate = 48e3f;
+    constexpr int signalLength = 48000;
+
+    std::vector<std::vector<float>> buffer { SignalGenerator::createSine<float>(1000, sampleRate, signalLength, -6.f),
+                                             SignalGenerator::createSine<float>(5000, sampleRate, signalLength, -6.f) };
+    SignalAdapterStdVecVec signal(buffer);
+
+    for (Averaging averaging : {Averaging::Mean, Averaging::Median, Averaging::MaxHold}) {
+        AnalyzedSignal analyzedSignal(signal, WelchSettings{0.5f, averaging, WindowType::Hann});
+        REQUIRE(check<HasSignalInAllBands>(analyzedSignal, {1}, Freqs{1000}, sampleRate));
+        REQUIRE(check<HasSignalInAllBands>(analyzedSignal, {2}, Freqs{5000}, sampleRate));
+        REQUIRE_FALSE(check<HasSignalInAllBands>(analyzedSignal, {1}, Freqs{5000}, sampleRate));
+        REQUIRE(check<HasSignalOnlyBelow>(analyzedSignal, {1}, 2000.f, sampleRate));
+        REQUIRE_FALSE(check<HasSignalOnlyBelow>(analyzedSignal, {}, 2000.f, sampleRate));
+        REQUIRE(check<HasSignalOnlyAbove>(analyzedSignal, {2}, 2000.f, sampleRate));
+
+        // every channel is analyzed only once
+        REQUIRE(analyzedSignal.getSpectrumCache().getNumEntries() == 2);
+        REQUIRE(analyzedSignal.getNormalizedBinValues(0) == FrequencyDomainHelpers::getWelchNormalizedBinValues(
+                    signal.getChannelView(0), FrequencyDomainHelpers::defaultFftLength, WelchSettings{0.5f, averaging, WindowType::Hann}));
+    }
+}
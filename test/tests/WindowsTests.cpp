@@ -0,0 +1,88 @@
+//
+//  ╔═╗┬ ┬┌┬┐┬┌─┐╔╦╗┬─┐┌─┐┬┌┬┐┌─┐
+//  ╠═╣│ │ ││││ │ ║ ├┬┘├─┤│ │ └─┐
+//  ╩ ╩└─┘─┴┘┴└─┘ ╩ ┴└─┴ ┴┴ ┴ └─┘
+//  
+//  © 2023 Lorenz Bucher - all rights reserved
+//  https://github.com/Sidelobe/AudioTraits
+
+#include "TestCommon.hpp"
+#include "SignalGenerator.hpp"
+
+#include <cmath>
+#include <vector>
+
+#ifdef SLB_AMALGATED_HEADER
+    #include "AudioTraits.hpp"
+#else
+    #include "FrequencyDomain/Helpers.hpp"
+    #include "FrequencyDomain/Windows.hpp"
+#endif
+
+using namespace slb;
+using namespace slb::AudioTraits;
+using namespace TestCommon;
+
+TEST_CASE("Window Tables Tests")
+{
+    int length = GENERATE(1, 2, 3, 16, 17, 1000, 4096);
+    
+    SECTION("Properties of all window types") {
+        for (WindowType type : {WindowType::Hann, WindowType::Hamming, WindowType::BlackmanHarris, WindowType::FlatTop}) {
+            const std::vector<float>& window = WindowTables::get(type, length);
+            REQUIRE(window.size() == length);
+            REQUIRE(window == WindowTables::calculate(type, length));
+            for (int i = 0; i < length; ++i) {
+                REQUIRE(window[i] == Approx(window[length - 1 - i]).margin(1e-6)); // symmetric
+                REQUIRE(window[i] <= 1.0001f);
+                REQUIRE(window[i] == static_cast<float>(calculateWindowValue(type, i, length)));
+            }
+            if (length % 2 == 1) {
+                REQUIRE(window[length / 2] == Approx(1.f).margin(1e-4)); // peak in the center
+            }
+        }
+    }
+    
+    SECTION("Hann window matches its definition") {
+        const std::vector<float>& window = WindowTables::get(WindowType::Hann, length);
+        for (int i = 0; length > 1 && i < length; ++i) {
+            double expected = 0.5 * (1 - std::cos(2*M_PI * i / (length - 1)));
+            REQUIRE(window[i] == Approx(expected).margin(1e-7));
+        }
+        REQUIRE(WindowTables::get(WindowType::Hamming, length).front() == Approx(length > 1 ? 0.08f : 1.f));
+    }
+    
+    SECTION("Tables are calculated once and shared") {
+        const std::vector<float>& hann = WindowTables::get(WindowType::Hann, length);
+        REQUIRE(&WindowTables::get(WindowType::Hann, length) == &hann);
+        REQUIRE(&WindowTables::get(WindowType::Hamming, length) != &hann);
+        REQUIRE(&WindowTables::get(WindowType::Hann, length + 1) != &hann);
+    }
+    
+    SECTION("Applying windows") {
+        std::vector<float> noise = SignalGenerator::createWhiteNoise(length);
+        
+        std::vector<float> expected = noise;
+        const std::vector<float>& window = WindowTables::get(WindowType::BlackmanHarris, length);
+        for (int i = 0; i < length; ++i) {
+            expected[i] *= window[i];
+        }
+        std::vector<float> windowed = noise;
+        applyWindow(windowed.data(), length, WindowType::BlackmanHarris);
+        REQUIRE(windowed == expected);
+        
+        std::vector<float> hannFloat = noise;
+        std::vector<double> hannDouble(noise.begin(), noise.end());
+        FrequencyDomainHelpers::applyHannWindow(hannFloat);
+        FrequencyDomainHelpers::applyHannWindow(hannDouble);
+        for (int i = 0; i < length; ++i) {
+            REQUIRE(hannFloat[i] == Approx(hannDouble[i]).margin(1e-7));
+            // double signals are windowed in double precision
+            const double hann = (length > 1) ? 0.5 * (1 - std::cos(2*M_PI * i / (length - 1))) : 1.0;
+            REQUIRE(hannDouble[i] == Approx(static_cast<double>(noise[i]) * hann).epsilon(1e-12).margin(1e-15));
+        }
+    }
+    
+    REQUIRE_THROWS(WindowTables::get(WindowType::Hann, 0));
+    REQUIRE_THROWS(WindowTables::calculate(WindowType::FlatTop, -1));
+}